@@ -0,0 +1,557 @@
+#pragma once
+
+#include <algorithm>
+#include <estd/BigInteger.h>
+#include <estd/BinaryLimbs.h>
+#include <string>
+#include <vector>
+
+namespace estd {
+    // Arbitrary precision integer in base 2^64 limbs (sign and magnitude), the counterpart of BigInteger for
+    // bit manipulation: shifts, bitwise operators and bit queries are O(n) instead of a decimal multiply per
+    // bit. The bitwise operators and testBit treat negative values as infinite two's complement (like Java's
+    // BigInteger) and >> rounds toward negative infinity. / truncates and % takes the sign of the dividend,
+    // like the built-in types. A BigBinaryInteger converts to BigInteger implicitly (the results of
+    // BigInteger's bitwise operators are BigBinaryIntegers), the other way round is explicit.
+    class BigBinaryInteger {
+        friend class BigInteger;
+        friend class BigFloat;
+
+    protected:
+        typedef binlimbs::uint128_t uint128_t;
+        typedef std::vector<uint64_t> Limbs;
+
+        Limbs limbs; // little endian, no leading zero limbs, empty for zero
+        bool isNegative = false;
+
+        inline BigBinaryInteger(Limbs magnitude, bool negative) : limbs(std::move(magnitude)), isNegative(negative) {
+            trim();
+        }
+
+        inline BigBinaryInteger& trim() {
+            limbs.resize(binlimbs::significantLimbs(limbs.data(), limbs.size()));
+            if (limbs.empty()) isNegative = false;
+            return *this;
+        }
+
+        inline static int compareMagnitude(const Limbs& a, const Limbs& b) {
+            if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+            for (size_t i = a.size(); i-- > 0;) {
+                if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+            }
+            return 0;
+        }
+
+        inline static Limbs addMagnitude(const Limbs& a, const Limbs& b) {
+            const Limbs& longer = a.size() >= b.size() ? a : b;
+            const Limbs& shorter = a.size() >= b.size() ? b : a;
+            Limbs result(longer.size() + 1);
+            uint64_t carry = 0;
+            for (size_t i = 0; i < longer.size(); i++) {
+                uint128_t sum = uint128_t(longer[i]) + (i < shorter.size() ? shorter[i] : 0) + carry;
+                result[i] = uint64_t(sum);
+                carry = uint64_t(sum >> 64);
+            }
+            result[longer.size()] = carry;
+            return result;
+        }
+
+        // a - b, a must not be smaller than b
+        inline static Limbs subtractMagnitude(const Limbs& a, const Limbs& b) {
+            Limbs result(a.size());
+            uint64_t borrow = 0;
+            for (size_t i = 0; i < a.size(); i++) {
+                uint64_t right = i < b.size() ? b[i] : 0;
+                result[i] = a[i] - right - borrow;
+                borrow = (a[i] < right) || (a[i] - right < borrow);
+            }
+            return result;
+        }
+
+        // x += y * 2^(64 * offset), x must have room for the sum
+        inline static void addAt(Limbs& x, const Limbs& y, size_t offset) {
+            uint64_t carry = 0;
+            for (size_t i = 0; i < y.size() || carry != 0; i++) {
+                uint128_t sum = uint128_t(x[offset + i]) + (i < y.size() ? y[i] : 0) + carry;
+                x[offset + i] = uint64_t(sum);
+                carry = uint64_t(sum >> 64);
+            }
+        }
+
+        // limbs [from, to) of x without leading zeros
+        inline static Limbs slice(const Limbs& x, size_t from, size_t to) {
+            to = std::min(to, x.size());
+            if (from >= to) return {};
+            return Limbs(x.begin() + from, x.begin() + from + binlimbs::significantLimbs(x.data() + from, to - from));
+        }
+
+        inline static Limbs multiplySimple(const Limbs& a, const Limbs& b) {
+            Limbs result(a.size() + b.size());
+            for (size_t i = 0; i < a.size(); i++) {
+                uint64_t carry = 0;
+                for (size_t j = 0; j < b.size(); j++) {
+                    uint128_t product = uint128_t(a[i]) * b[j] + result[i + j] + carry;
+                    result[i + j] = uint64_t(product);
+                    carry = uint64_t(product >> 64);
+                }
+                result[i + b.size()] = carry;
+            }
+            return result;
+        }
+
+        // karatsuba like BigInteger's: a = a1 * 2^(64m) + a0 and b alike give a0 * b0, a1 * b1 and
+        // (a0 + a1) * (b0 + b1) - a0 * b0 - a1 * b1 at offsets 0, 2m and m. An operand of at most m limbs
+        // only splits the other one
+        inline static Limbs multiplyMagnitude(const Limbs& a, const Limbs& b) {
+            if (a.empty() || b.empty()) return {};
+            if (std::min(a.size(), b.size()) < karatsubaThreshold) return multiplySimple(a, b);
+            size_t m = std::max(a.size(), b.size()) / 2;
+            Limbs result(a.size() + b.size() + 1, 0);
+            if (std::min(a.size(), b.size()) <= m) {
+                const Limbs& longer = a.size() > b.size() ? a : b;
+                const Limbs& shorter = a.size() > b.size() ? b : a;
+                addAt(result, multiplyMagnitude(slice(longer, 0, m), shorter), 0);
+                addAt(result, multiplyMagnitude(slice(longer, m, longer.size()), shorter), m);
+                return result;
+            }
+
+            Limbs a0 = slice(a, 0, m), a1 = slice(a, m, a.size()), b0 = slice(b, 0, m), b1 = slice(b, m, b.size());
+            Limbs z0 = multiplyMagnitude(a0, b0), z2 = multiplyMagnitude(a1, b1);
+            Limbs z1 = multiplyMagnitude(addMagnitude(a0, a1), addMagnitude(b0, b1));
+            z1 = subtractMagnitude(subtractMagnitude(z1, z0), z2);
+            addAt(result, z0, 0);
+            addAt(result, slice(z1, 0, z1.size()), m);
+            addAt(result, z2, 2 * m);
+            return result;
+        }
+
+        // {quotient, remainder} of the magnitudes
+        inline static std::pair<Limbs, Limbs> divideMagnitude(const Limbs& a, const Limbs& b) {
+            if (b.empty()) throw std::invalid_argument("Cannot divide by zero");
+            if (compareMagnitude(a, b) < 0) return {{}, a};
+            Limbs quotient(a.size() - b.size() + 1), remainder(b.size()), scratch(a.size() + b.size() + 1);
+            binlimbs::divide(a.data(), a.size(), b.data(), b.size(), quotient.data(), remainder.data(), scratch.data());
+            return {quotient, remainder};
+        }
+
+        // left + right, or left - right when flip is set
+        inline static BigBinaryInteger
+        addSigned(const BigBinaryInteger& left, const BigBinaryInteger& right, bool flip) {
+            bool rightNegative = right.isNegative != flip;
+            if (left.isNegative == rightNegative) return {addMagnitude(left.limbs, right.limbs), left.isNegative};
+            if (compareMagnitude(left.limbs, right.limbs) >= 0) {
+                return {subtractMagnitude(left.limbs, right.limbs), left.isNegative};
+            }
+            return {subtractMagnitude(right.limbs, left.limbs), rightNegative};
+        }
+
+        // the lowest n limbs of the two's complement, n must exceed the magnitude so the sign fits
+        inline Limbs twosComplement(size_t n) const {
+            Limbs result(n, 0);
+            std::copy(limbs.begin(), limbs.end(), result.begin());
+            if (!isNegative) return result;
+            uint64_t carry = 1;
+            for (auto& limb : result) {
+                limb = ~limb + carry;
+                carry = carry && limb == 0;
+            }
+            return result;
+        }
+
+        inline static BigBinaryInteger fromTwosComplement(Limbs x) {
+            bool negative = !x.empty() && (x.back() >> 63) != 0;
+            if (negative) {
+                uint64_t carry = 1;
+                for (auto& limb : x) {
+                    limb = ~limb + carry;
+                    carry = carry && limb == 0;
+                }
+            }
+            return {std::move(x), negative};
+        }
+
+        template <class Op>
+        inline static BigBinaryInteger bitwise(const BigBinaryInteger& left, const BigBinaryInteger& right, Op op) {
+            size_t n = std::max(left.limbs.size(), right.limbs.size()) + 1;
+            Limbs a = left.twosComplement(n);
+            Limbs b = right.twosComplement(n);
+            for (size_t i = 0; i < n; i++) a[i] = op(a[i], b[i]);
+            return fromTwosComplement(std::move(a));
+        }
+
+        inline static Limbs shiftLeft(const Limbs& x, size_t shift) {
+            if (x.empty()) return {};
+            size_t limbShift = shift / 64;
+            unsigned bitShift = shift % 64;
+            Limbs result(x.size() + limbShift + 1, 0);
+            for (size_t i = 0; i < x.size(); i++) {
+                result[i + limbShift] |= x[i] << bitShift;
+                if (bitShift != 0) result[i + limbShift + 1] = x[i] >> (64 - bitShift);
+            }
+            return result;
+        }
+
+        inline static Limbs shiftRight(const Limbs& x, size_t shift) {
+            size_t limbShift = shift / 64;
+            unsigned bitShift = shift % 64;
+            if (limbShift >= x.size()) return {};
+            Limbs result(x.size() - limbShift);
+            for (size_t i = 0; i < result.size(); i++) {
+                result[i] = x[i + limbShift] >> bitShift;
+                if (bitShift != 0 && i + limbShift + 1 < x.size()) result[i] |= x[i + limbShift + 1] << (64 - bitShift);
+            }
+            return result;
+        }
+
+        // horner's rule over pairs of base 10^9 blocks, most significant block first
+        inline static Limbs fromDecimalHorner(const uint32_t* blocks, size_t n) {
+            Limbs result;
+            for (size_t i = 0; i < n; i += 2) {
+                bool pair = i + 1 < n;
+                uint64_t chunk = pair ? uint64_t(blocks[i]) * 1000000000 + blocks[i + 1] : blocks[i];
+                uint64_t carry = binlimbs::multiplyAddSmall(
+                    result.data(), result.size(), pair ? 1000000000000000000 : 1000000000, chunk
+                );
+                if (carry != 0) result.push_back(carry);
+            }
+            return result;
+        }
+
+        // divide and conquer over blocks: the lowest 2^j blocks for the largest 2^j below their number and the
+        // blocks above convert separately and combine as high * powers[j] + low, powers[j] = 10^(9 * 2^j)
+        inline static Limbs fromDecimalSplit(const uint32_t* blocks, size_t n, const std::vector<Limbs>& powers) {
+            if (n <= 2 * conversionThreshold) return fromDecimalHorner(blocks, n); // a limb holds 2.1 blocks
+            size_t j = 0;
+            while ((size_t(2) << j) < n) j++;
+            size_t low = size_t(1) << j;
+            Limbs high = fromDecimalSplit(blocks, n - low, powers);
+            return addMagnitude(multiplyMagnitude(slice(high, 0, high.size()), powers[j]),
+                                fromDecimalSplit(blocks + n - low, low, powers));
+        }
+
+        inline static BigBinaryInteger fromDecimal(const BigInteger& val) {
+            const uint32_t* blocks = val.number.begin();
+            size_t n = val.number.size();
+            if (n <= 2 * conversionThreshold) return {fromDecimalHorner(blocks, n), val.isNegative};
+            std::vector<Limbs> powers = {{1000000000}};
+            while ((size_t(1) << powers.size()) < n) {
+                Limbs square = multiplyMagnitude(powers.back(), powers.back());
+                powers.push_back(slice(square, 0, square.size()));
+            }
+            return {fromDecimalSplit(blocks, n, powers), val.isNegative};
+        }
+
+        // 2^(64 * 2^j) for every j with 2^j < limbs, each the square of the one before
+        inline static std::vector<BigInteger> limbPowers(size_t limbs) {
+            std::vector<BigInteger> powers = {BigInteger("18446744073709551616")};
+            while ((size_t(1) << powers.size()) < limbs) powers.push_back(powers.back() * powers.back());
+            return powers;
+        }
+
+        // repeated division by 10^18, two blocks per pass
+        inline static BigInteger toDecimalDivision(const uint64_t* x, size_t n) {
+            BigInteger result = nullptr;
+            Limbs tmp(x, x + n);
+            while (n > 0) {
+                uint64_t chunk = binlimbs::divideSmall(tmp.data(), n, 1000000000000000000);
+                n = binlimbs::significantLimbs(tmp.data(), n);
+                result.number.push_front(chunk % 1000000000);
+                if (n > 0 || chunk >= 1000000000) result.number.push_front(chunk / 1000000000);
+            }
+            if (result.number.size() == 0) result.number.push_front(0);
+            return result;
+        }
+
+        // divide and conquer: the lowest 2^j limbs for the largest 2^j below the length and the limbs above
+        // convert separately and combine as high * 2^(64 * 2^j) + low with the decimal multiplication
+        inline static BigInteger toDecimalSplit(const uint64_t* x, size_t n, const std::vector<BigInteger>& powers) {
+            n = binlimbs::significantLimbs(x, n);
+            if (n <= conversionThreshold) return toDecimalDivision(x, n);
+            size_t j = 0;
+            while ((size_t(2) << j) < n) j++;
+            size_t half = size_t(1) << j;
+            return toDecimalSplit(x + half, n - half, powers) * powers[j] + toDecimalSplit(x, half, powers);
+        }
+
+        inline static uint32_t digitValue(char c, uint32_t base) {
+            uint32_t digit = decimalblocks::digitValue(c);
+            if (digit >= base) throw std::invalid_argument("Invalid digit in binary integer string");
+            return digit;
+        }
+
+    public:
+        // conversions from and to BigInteger split values of more limbs than this in halves, the quadratic
+        // loops convert the smaller ones
+        static inline size_t conversionThreshold = 40;
+
+        // products of operands with at least this many limbs each are split in halves (karatsuba)
+        static inline size_t karatsubaThreshold = 40;
+
+        //Constructors
+        inline BigBinaryInteger() {}
+        // template for integer types
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigBinaryInteger(T val) {
+            uint64_t magnitude = uint64_t(val);
+            if constexpr (std::is_signed<T>::value) {
+                if (val < 0) {
+                    magnitude = 0 - magnitude;
+                    isNegative = true;
+                }
+            }
+            if (magnitude != 0) limbs.push_back(magnitude);
+        }
+        // 0x and 0b prefixed strings are read directly, anything else goes through BigInteger
+        inline BigBinaryInteger(const std::string& val) {
+            size_t start = !val.empty() && val[0] == '-';
+            uint32_t base = 0;
+            if (val.size() > start + 2 && val[start] == '0') {
+                if (val[start + 1] == 'x' || val[start + 1] == 'X') base = 16;
+                if (val[start + 1] == 'b' || val[start + 1] == 'B') base = 2;
+            }
+            if (base == 0) {
+                *this = BigBinaryInteger(BigInteger(val));
+                return;
+            }
+            unsigned bitsPerDigit = base == 16 ? 4 : 1;
+            size_t bit = 0;
+            for (size_t i = val.size(); i-- > start + 2;) {
+                if (val[i] == '\'') continue;
+                uint64_t digit = digitValue(val[i], base);
+                if (bit / 64 == limbs.size()) limbs.push_back(0);
+                limbs[bit / 64] |= digit << (bit % 64);
+                bit += bitsPerDigit;
+            }
+            isNegative = start == 1;
+            trim();
+        }
+        inline BigBinaryInteger(const char* val) : BigBinaryInteger(std::string(val)) {}
+        // uses (and fills) the value's cached binary form
+        inline explicit BigBinaryInteger(const BigInteger& val) : BigBinaryInteger(val.toBinary()) {}
+
+        // repeated division by 10^18 for small values, halves joined by powers of 2^64 for large ones
+        inline BigInteger toBigInteger() const {
+            size_t n = limbs.size();
+            BigInteger result = n <= conversionThreshold ? toDecimalDivision(limbs.data(), n)
+                                                         : toDecimalSplit(limbs.data(), n, limbPowers(n));
+            if (isNegative) result = -result;
+            return result;
+        }
+
+        // the result keeps this value as its cached binary form
+        inline operator BigInteger() const;
+
+        inline bool isZero() const { return limbs.empty(); }
+        // limb i of the magnitude, little endian
+        inline uint64_t getLimb(size_t i) const { return i < limbs.size() ? limbs[i] : 0; }
+
+        //Operations
+        inline BigBinaryInteger operator+(const BigBinaryInteger& right) const {
+            return addSigned(*this, right, false);
+        }
+        inline BigBinaryInteger operator-(const BigBinaryInteger& right) const {
+            return addSigned(*this, right, true);
+        }
+        inline BigBinaryInteger operator-() const { return {limbs, !isNegative}; }
+        inline BigBinaryInteger operator*(const BigBinaryInteger& right) const {
+            return {multiplyMagnitude(limbs, right.limbs), isNegative != right.isNegative};
+        }
+        inline BigBinaryInteger operator/(const BigBinaryInteger& right) const {
+            return {divideMagnitude(limbs, right.limbs).first, isNegative != right.isNegative};
+        }
+        inline BigBinaryInteger operator%(const BigBinaryInteger& right) const {
+            return {divideMagnitude(limbs, right.limbs).second, isNegative};
+        }
+
+        inline BigBinaryInteger& operator+=(const BigBinaryInteger& right) { return (*this) = (*this) + right; }
+        inline BigBinaryInteger& operator-=(const BigBinaryInteger& right) { return (*this) = (*this) - right; }
+        inline BigBinaryInteger& operator*=(const BigBinaryInteger& right) { return (*this) = (*this) * right; }
+        inline BigBinaryInteger& operator/=(const BigBinaryInteger& right) { return (*this) = (*this) / right; }
+        inline BigBinaryInteger& operator%=(const BigBinaryInteger& right) { return (*this) = (*this) % right; }
+
+        // (this ^ p) % m for p >= 0 and m > 0, the result is in [0, m)
+        inline BigBinaryInteger powerMod(const BigBinaryInteger& p, const BigBinaryInteger& m) const {
+            if (p.isNegative) throw std::invalid_argument("Negative exponent");
+            BigBinaryInteger result = BigBinaryInteger(1) % m;
+            BigBinaryInteger base = *this % m;
+            if (base.isNegative) base += m;
+            for (size_t i = 0, bits = p.bitLength(); i < bits; i++) {
+                if (p.testBit(i)) result = result * base % m;
+                base = base * base % m;
+            }
+            return result;
+        }
+
+        //Bitwise operations (two's complement)
+        inline BigBinaryInteger operator&(const BigBinaryInteger& right) const {
+            if (!isNegative && !right.isNegative) { // no sign extension needed
+                Limbs result(std::min(limbs.size(), right.limbs.size()));
+                for (size_t i = 0; i < result.size(); i++) result[i] = limbs[i] & right.limbs[i];
+                return {std::move(result), false};
+            }
+            return bitwise(*this, right, [](uint64_t a, uint64_t b) { return a & b; });
+        }
+        inline BigBinaryInteger operator|(const BigBinaryInteger& right) const {
+            return bitwise(*this, right, [](uint64_t a, uint64_t b) { return a | b; });
+        }
+        inline BigBinaryInteger operator^(const BigBinaryInteger& right) const {
+            return bitwise(*this, right, [](uint64_t a, uint64_t b) { return a ^ b; });
+        }
+        // -this - 1
+        inline BigBinaryInteger operator~() const { return -*this - 1; }
+
+        inline BigBinaryInteger& operator&=(const BigBinaryInteger& right) { return (*this) = (*this) & right; }
+        inline BigBinaryInteger& operator|=(const BigBinaryInteger& right) { return (*this) = (*this) | right; }
+        inline BigBinaryInteger& operator^=(const BigBinaryInteger& right) { return (*this) = (*this) ^ right; }
+
+        inline BigBinaryInteger operator<<(size_t shift) const { return {shiftLeft(limbs, shift), isNegative}; }
+        // floor(this / 2^shift)
+        inline BigBinaryInteger operator>>(size_t shift) const {
+            if (!isNegative) return {shiftRight(limbs, shift), false};
+            // -((|x| - 1) >> shift) - 1
+            Limbs smaller = subtractMagnitude(limbs, {1});
+            BigBinaryInteger result = {shiftRight(smaller, shift), false};
+            return -(result + 1);
+        }
+        inline BigBinaryInteger& operator<<=(size_t shift) { return (*this) = (*this) << shift; }
+        inline BigBinaryInteger& operator>>=(size_t shift) { return (*this) = (*this) >> shift; }
+
+        // bit of the two's complement, negative values have infinitely many leading ones
+        inline bool testBit(size_t bit) const {
+            size_t limb = bit / 64;
+            bool magnitudeBit = limb < limbs.size() && (limbs[limb] >> (bit % 64)) & 1;
+            if (!isNegative) return magnitudeBit;
+            // -m = ~(m - 1): below the lowest set bit of m the bits are 0, at it 1, above it inverted
+            size_t lowest = 0;
+            while (limbs[lowest] == 0) lowest++;
+            lowest = lowest * 64 + __builtin_ctzll(limbs[lowest]);
+            if (bit <= lowest) return bit == lowest;
+            return !magnitudeBit;
+        }
+
+        // bits of the magnitude
+        inline size_t bitLength() const { return binlimbs::bitLength(limbs.data(), limbs.size()); }
+
+        // set bits of the magnitude
+        inline size_t popcount() const {
+            size_t result = 0;
+            for (auto limb : limbs) result += __builtin_popcountll(limb);
+            return result;
+        }
+
+        //Comparators
+        inline bool operator==(const BigBinaryInteger& right) const {
+            return isNegative == right.isNegative && limbs == right.limbs;
+        }
+        inline bool operator!=(const BigBinaryInteger& right) const { return !(operator==(right)); }
+        inline bool operator<(const BigBinaryInteger& right) const {
+            if (isNegative != right.isNegative) return isNegative;
+            int magnitude = compareMagnitude(limbs, right.limbs);
+            return isNegative ? magnitude > 0 : magnitude < 0;
+        }
+        inline bool operator>(const BigBinaryInteger& right) const { return right < *this; }
+        inline bool operator<=(const BigBinaryInteger& right) const { return !(right < *this); }
+        inline bool operator>=(const BigBinaryInteger& right) const { return !(*this < right); }
+
+        inline friend std::ostream& operator<<(std::ostream& out, const BigBinaryInteger& right) {
+            return out << right.toString();
+        }
+
+        // base 2 and 16 are written directly (without prefix), base 10 goes through BigInteger
+        inline std::string toString(unsigned base = 10) const {
+            if (base == 10) return toBigInteger().toString();
+            if (base != 2 && base != 16) throw std::invalid_argument("Unsupported base");
+            if (limbs.empty()) return "0";
+            unsigned bitsPerDigit = base == 16 ? 4 : 1;
+            std::string result;
+            for (size_t bit = 0, bits = bitLength(); bit < bits; bit += bitsPerDigit) {
+                uint64_t digit = (limbs[bit / 64] >> (bit % 64)) & (base - 1);
+                result.push_back("0123456789abcdef"[digit]);
+            }
+            if (isNegative) result.push_back('-');
+            std::reverse(result.begin(), result.end());
+            return result;
+        }
+    };
+
+    typedef BigBinaryInteger BigBinInt;
+
+    // a BigInteger's binary form together with the blocks it was built from
+    struct BinaryMirror {
+        std::atomic<size_t> references{1};
+        BlockBuffer source;
+        bool negative;
+        BigBinaryInteger value;
+
+        // copies of the value share the mirror and may outlive an arena the blocks came from, so the mirror keeps
+        // its blocks on the heap: shared (copy on write) with heap backed values, copied out of anything else
+        inline BinaryMirror(const BlockBuffer& number, bool isNegative, BigBinaryInteger binary)
+            : source(number, nullptr), negative(isNegative), value(std::move(binary)) {}
+
+        inline bool matches(const BlockBuffer& number, bool isNegative) const {
+            if (negative != isNegative || source.size() != number.size()) return false;
+            return source.begin() == number.begin() || std::equal(source.begin(), source.end(), number.begin());
+        }
+    };
+
+    inline BinaryMirror* BigInteger::MirrorCache::retain(BinaryMirror* value) {
+        if (value) value->references.fetch_add(1, std::memory_order_relaxed);
+        return value;
+    }
+
+    inline void BigInteger::MirrorCache::release(BinaryMirror* value) {
+        if (value && value->references.fetch_sub(1, std::memory_order_acq_rel) == 1) delete value;
+    }
+
+    inline const BigBinaryInteger& BigInteger::binaryForm(BigBinaryInteger& fallback) const {
+        BinaryMirror* cached = binaryMirror.get();
+        if (cached && cached->matches(number, isNegative)) return cached->value;
+        BinaryMirror* fresh = new BinaryMirror(number, isNegative, BigBinaryInteger::fromDecimal(*this));
+        if (!cached && binaryMirror.install(fresh)) return fresh->value;
+        // a stale mirror is only replaced by assignment, readers on other threads may still hold it
+        fallback = std::move(fresh->value);
+        delete fresh;
+        return fallback;
+    }
+
+    inline BigBinaryInteger::operator BigInteger() const {
+        BigInteger result = toBigInteger();
+        BinaryMirror* mirror = new BinaryMirror(result.number, result.isNegative, *this);
+        if (!result.binaryMirror.install(mirror)) delete mirror;
+        return result;
+    }
+
+    inline BigBinaryInteger BigInteger::toBinary() const {
+        BigBinaryInteger fallback;
+        return binaryForm(fallback);
+    }
+
+    inline BigBinaryInteger BigInteger::operator&(const BigInteger& right) const {
+        BigBinaryInteger leftFallback, rightFallback;
+        return binaryForm(leftFallback) & right.binaryForm(rightFallback);
+    }
+    inline BigBinaryInteger BigInteger::operator|(const BigInteger& right) const {
+        BigBinaryInteger leftFallback, rightFallback;
+        return binaryForm(leftFallback) | right.binaryForm(rightFallback);
+    }
+    inline BigBinaryInteger BigInteger::operator^(const BigInteger& right) const {
+        BigBinaryInteger leftFallback, rightFallback;
+        return binaryForm(leftFallback) ^ right.binaryForm(rightFallback);
+    }
+    inline BigBinaryInteger BigInteger::operator~() const {
+        BigBinaryInteger fallback;
+        return ~binaryForm(fallback);
+    }
+    inline BigInteger& BigInteger::operator&=(const BigInteger& right) { return (*this) = (*this) & right; }
+    inline BigInteger& BigInteger::operator|=(const BigInteger& right) { return (*this) = (*this) | right; }
+    inline BigInteger& BigInteger::operator^=(const BigInteger& right) { return (*this) = (*this) ^ right; }
+
+    inline bool BigInteger::testBit(size_t bit) const {
+        BigBinaryInteger fallback;
+        return binaryForm(fallback).testBit(bit);
+    }
+    inline size_t BigInteger::bitLength() const {
+        BigBinaryInteger fallback;
+        return binaryForm(fallback).bitLength();
+    }
+} // namespace estd
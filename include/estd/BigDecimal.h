@@ -1,21 +1,55 @@
 #pragma once
 
-#include <deque>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <estd/BigInteger.h>
 #include <exception>
+#include <functional>
 #include <iomanip>
+#include <limits>
 #include <map>
 #include <sstream>
 
 namespace estd {
+    enum class RoundingMode {
+        UP,        // away from zero
+        DOWN,      // towards zero (truncate)
+        CEILING,   // towards positive infinity
+        FLOOR,     // towards negative infinity
+        HALF_UP,   // to nearest, ties away from zero
+        HALF_DOWN, // to nearest, ties towards zero
+        HALF_EVEN, // to nearest, ties to the even neighbour (bankers rounding)
+    };
+
+    struct MathContext {
+        size_t precision = 0; // number of significant digits, 0 means unlimited
+        RoundingMode roundingMode = RoundingMode::HALF_EVEN;
+
+        inline static MathContext unlimited() { return MathContext{0, RoundingMode::HALF_UP}; }
+        inline static MathContext decimal32() { return MathContext{7, RoundingMode::HALF_EVEN}; }
+        inline static MathContext decimal64() { return MathContext{16, RoundingMode::HALF_EVEN}; }
+        inline static MathContext decimal128() { return MathContext{34, RoundingMode::HALF_EVEN}; }
+    };
+
     class BigDecimal {
         friend class BigInteger;
+        friend class BigDecimalArray;
+        friend class BigDecimalAccumulator;
+        friend class BigFloat;
+        friend class BigRational;
+        template <size_t Scale>
+        friend class FixedDecimal;
 
     protected:
         estd::BigInteger parent = 0;
         size_t index = 0; // this defines how many digits in base 10 are after the decimal point.
 
         inline void addTrailZeros(size_t z) {
+            if (parent.isZero()) { // keep a single zero block, no leading zeros
+                index += z;
+                return;
+            }
             while (z % 9 != 0) {
                 z -= 1;
                 index += 1;
@@ -47,20 +81,101 @@ namespace estd {
         }
 
         inline BigDecimal& trimTrailingZeros() {
+            if (parent.number.size() == 0) return *this;
+            if (parent.isZero()) { //special case, this is a zero, avoid removing everything
+                index = 0;
+                return *this;
+            }
             while (index >= 9 && parent.number.size() > 1 && parent.number[parent.number.size() - 1] == 0) {
                 parent.number.pop_back();
                 index -= 9;
             }
-            while (index > 0 && parent.number.size() > 0 && parent.number[parent.number.size() - 1] % 10 == 0) {
-                if (parent.number.size() == 1 &&
-                    parent.number[0] == 0) { //special case, this is a zero, return to avoid removing everything
-                    index = 0;
-                    break;
-                }
-                parent.number = parent.operator*(1000000000 / 10).number; // great way to divide by 10
+            // count the zeros in the last block and remove them all with a single pass
+            uint32_t last = parent.number[parent.number.size() - 1];
+            size_t zeros = 0;
+            while (zeros < index && zeros < 9 && last % 10 == 0) {
+                last /= 10;
+                zeros++;
+            }
+            if (zeros != 0) {
+                uint32_t multiplier = 1;
+                for (size_t i = zeros; i < 9; i++) multiplier *= 10;
+                parent.number = parent.operator*(multiplier).number; // great way to divide by 10^zeros
                 parent.number.pop_back();
-                index--;
+                index -= zeros;
+            }
+            return *this;
+        }
+
+        // trims only once the coefficient has grown past normalizeThreshold blocks, otherwise the
+        // unnormalized (coefficient, index) pair is kept until the value is observed.
+        inline BigDecimal& lazyNormalize() {
+            if (parent.number.size() > normalizeThreshold) trimTrailingZeros();
+            return *this;
+        }
+
+        // drops the lowest `drop` digits of the coefficient and rounds what is left according to mode,
+        // sticky signals that there are nonzero digits below the coefficient (e.g. a division remainder).
+        // digits that cannot be moved past the decimal point are kept as zeros in the coefficient.
+        inline BigDecimal& roundDigits(size_t drop, RoundingMode mode, bool sticky = false) {
+            if (drop == 0 && !sticky) return *this;
+
+            bool negative = parent.isNegative;
+            BigInteger magnitude = parent;
+            magnitude.isNegative = false;
+
+            uint32_t digit = 0; // most significant dropped digit
+            size_t blocks = drop / 9;
+            size_t digits = drop % 9;
+            if (blocks >= magnitude.number.size()) {
+                sticky = sticky || !magnitude.isZero();
+                magnitude = 0;
+            } else {
+                for (size_t i = 0; i < blocks; i++) {
+                    uint32_t token = magnitude.number[magnitude.number.size() - 1];
+                    magnitude.number.pop_back();
+                    if (i + 1 == blocks && digits == 0) {
+                        digit = token / 100000000;
+                        token %= 100000000;
+                    }
+                    sticky = sticky || token != 0;
+                }
+                if (digits != 0) {
+                    uint32_t divisor = 1;
+                    for (size_t i = 1; i < digits; i++) divisor *= 10;
+                    auto split = magnitude.unsignedDivideSmall(magnitude, divisor * 10);
+                    magnitude = split.first;
+                    digit = split.second / divisor;
+                    sticky = sticky || (split.second % divisor) != 0;
+                }
+            }
+
+            bool odd = magnitude.number[magnitude.number.size() - 1] % 2 == 1;
+            bool increment = false;
+            switch (mode) {
+                case RoundingMode::UP: increment = digit != 0 || sticky; break;
+                case RoundingMode::DOWN: increment = false; break;
+                case RoundingMode::CEILING: increment = !negative && (digit != 0 || sticky); break;
+                case RoundingMode::FLOOR: increment = negative && (digit != 0 || sticky); break;
+                case RoundingMode::HALF_UP: increment = digit >= 5; break;
+                case RoundingMode::HALF_DOWN: increment = digit > 5 || (digit == 5 && sticky); break;
+                case RoundingMode::HALF_EVEN: increment = digit > 5 || (digit == 5 && (sticky || odd)); break;
+            }
+            if (increment) magnitude = magnitude.unsignedAdd(magnitude, 1);
+
+            if (drop > index) {
+                size_t zeros = drop - index;
+                parent = magnitude;
+                parent.isNegative = negative;
+                index = 0;
+                addTrailZeros(zeros);
+                index = 0;
+            } else {
+                parent = magnitude;
+                parent.isNegative = negative;
+                index -= drop;
             }
+            if (parent.isZero()) parent.isNegative = false;
             return *this;
         }
 
@@ -73,13 +188,256 @@ namespace estd {
             return right.index;
         }
 
+        // position of the leading digit, 10^adjustedExponent() <= |value| < 10^(adjustedExponent() + 1)
+        inline int64_t adjustedExponent() const { return int64_t(parent.getNumDigits()) - 1 - int64_t(index); }
+
+        // 10^exponent, exponent may be negative
+        inline static BigDecimal powerOfTen(int64_t exponent) {
+            BigDecimal result = nullptr;
+            result.parent = BigInteger::powerOfTen(exponent < 0 ? 0 : exponent);
+            result.index = exponent < 0 ? -exponent : 0;
+            return result;
+        }
+
+        // Ziv's rounding test: approx is known to within a few units of its working-th significant digit,
+        // only accept it if every value inside that error bound rounds to the same result.
+        inline static bool
+        roundIfSafe(const BigDecimal& approx, size_t working, const MathContext& mc, BigDecimal& out) {
+            BigDecimal error = powerOfTen(approx.adjustedExponent() - int64_t(working) + 3);
+            BigDecimal low = approx - error;
+            BigDecimal high = approx + error;
+            low.round(mc);
+            high.round(mc);
+            if (low != high) return false;
+            out = low;
+            return true;
+        }
+
+        // binary splitting state, the partial sum over a range of terms is t / q
+        struct SeriesSplit {
+            BigInteger p, q, t;
+        };
+
+        // terms of exp(a / b) = sum (a / b)^i / i!, so p(i) = a and q(i) = i * b (p(0) = q(0) = 1)
+        inline static SeriesSplit expSplit(const BigInteger& a, const BigInteger& b, size_t left, size_t right) {
+            if (right - left == 1) {
+                if (left == 0) return {1, 1, 1};
+                return {a, b * BigInteger(left), a};
+            }
+            size_t middle = (left + right) / 2;
+            SeriesSplit l = expSplit(a, b, left, middle);
+            SeriesSplit r = expSplit(a, b, middle, right);
+            return {l.p * r.p, l.q * r.q, l.t * r.q + l.p * r.t};
+        }
+
+        // terms of the chudnovsky series for 1 / pi
+        inline static SeriesSplit chudnovskySplit(size_t left, size_t right) {
+            if (right - left == 1) {
+                if (left == 0) return {1, 1, 13591409};
+                BigInteger a = left;
+                BigInteger p = (a * 6 - 5) * (a * 2 - 1) * (a * 6 - 1);
+                BigInteger q = a * a * a * uint64_t(10939058860032000); // 640320^3 / 24
+                BigInteger t = p * (a * 545140134 + 13591409);
+                if (left % 2 == 1) t.isNegative = !t.isNegative;
+                return {p, q, t};
+            }
+            size_t middle = (left + right) / 2;
+            SeriesSplit l = chudnovskySplit(left, middle);
+            SeriesSplit r = chudnovskySplit(middle, right);
+            return {l.p * r.p, l.q * r.q, l.t * r.q + l.p * r.t};
+        }
+
+        // exp(x) for |x| < 1 to `working` digits, x is split into chunks of 1, 2, 4, 8... digits ("bit-burst"),
+        // every chunk has a short numerator so its series is cheap to sum by binary splitting
+        inline static BigDecimal expSmall(const BigDecimal& x, size_t working) {
+            MathContext mc = {working + 2, RoundingMode::HALF_EVEN};
+            BigDecimal result = 1;
+            BigInteger magnitude = x.parent;
+            magnitude.isNegative = false;
+
+            for (size_t low = 1; low <= x.index; low *= 2) {
+                size_t high = std::min(2 * low - 1, x.index);
+                BigInteger chunk = magnitude.unsignedDivide(magnitude, BigInteger::powerOfTen(x.index - high)).first;
+                chunk = chunk.unsignedDivide(chunk, BigInteger::powerOfTen(high - low + 1)).second;
+                if (chunk.isZero()) continue;
+                chunk.isNegative = x.parent.isNegative;
+
+                // every term is at most 10^-(low - 1) times the previous one divided by i
+                size_t terms = 1;
+                double digits = 0;
+                while (digits < working + 2) {
+                    digits += (low - 1) + std::log10(double(terms));
+                    terms++;
+                }
+
+                SeriesSplit split = expSplit(chunk, BigInteger::powerOfTen(high), 0, terms);
+                result = result.multiply(BigDecimal(split.t).divide(BigDecimal(split.q), mc), mc);
+            }
+            return result;
+        }
+
+        // exp(x) to `working` significant digits (within a few units of the last one)
+        inline static BigDecimal expApprox(const BigDecimal& x, size_t working) {
+            // x = r * 2^k with |r| < 2^-8, then exp(x) = exp(r)^(2^k), every squaring doubles the error
+            int64_t integerDigits = std::max<int64_t>(0, x.adjustedExponent() + 1);
+            size_t k = size_t(integerDigits * 3.33) + 8;
+            size_t extended = working + size_t(k * 0.302) + 3;
+
+            BigDecimal r = x * BigDecimal(BigInteger(5).power(k)); // x / 2^k = x * 5^k / 10^k, exactly
+            r.index += k;
+            if (r.index > extended + 3) r.roundDigits(r.index - (extended + 3), RoundingMode::HALF_EVEN);
+
+            MathContext mc = {extended, RoundingMode::HALF_EVEN};
+            BigDecimal result = expSmall(r, extended);
+            for (size_t i = 0; i < k; i++) result = result.multiply(result, mc);
+            return result;
+        }
+
+        // ln(x) to `working` significant digits by halley's iteration y += 2 (x - e^y) / (x + e^y),
+        // the precision is doubled (at least) every step so the cost is dominated by the last exp
+        inline static BigDecimal lnApprox(const BigDecimal& x, size_t working) {
+            // close to 1 the result has leading zeros that the iteration has to resolve absolutely
+            size_t extra = 5;
+            BigDecimal distance = x - 1;
+            if (!distance.parent.isZero() && distance.adjustedExponent() < 0) extra += -distance.adjustedExponent();
+
+            // starting point from the leading blocks in double precision
+            const auto& blocks = x.parent.number;
+            double leading = blocks[0];
+            int64_t exponent = -int64_t(x.index);
+            if (blocks.size() >= 2) {
+                leading = leading * 1e9 + blocks[1];
+                exponent += 9 * int64_t(blocks.size() - 2);
+            }
+            BigDecimal y = std::log(leading) + double(exponent) * std::log(10.0);
+            if (extra > 20) y = distance; // ln(1 + d) ~ d, more accurate than the double estimate
+
+            std::vector<size_t> steps;
+            for (size_t p = working + extra; p > 12; p = (p + 2) / 2) steps.push_back(p);
+            for (auto p = steps.rbegin(); p != steps.rend(); ++p) {
+                MathContext mc = {*p + extra, RoundingMode::HALF_EVEN};
+                BigDecimal ey = expApprox(y, *p + extra);
+                BigDecimal correction = (x - ey).multiply(2, mc).divide(x + ey, mc);
+                y = y.add(correction, mc);
+            }
+            return y;
+        }
+
+        // x^p = exp(p * ln(x)) for a positive x
+        inline BigDecimal powerFractional(const BigDecimal& p, const MathContext& mc) const {
+            if (mc.precision == 0) throw std::invalid_argument("Fractional power needs a MathContext with a precision");
+            if (parent.isZero()) {
+                if (p.parent.isNegative) throw std::invalid_argument("Cannot divide by zero");
+                return 0;
+            }
+            if (parent.isNegative) throw std::invalid_argument("Power cannot be a fraction for a negative base");
+
+            // the exponent p * ln(x) needs as many extra digits as it has integer digits
+            int64_t lnDigits = int64_t(std::log10(std::abs(double(adjustedExponent())) * 2.31 + 3)) + 1;
+            size_t extra = std::max<int64_t>(0, p.adjustedExponent() + 1 + lnDigits);
+
+            BigDecimal result = nullptr;
+            for (size_t guard = 8;; guard *= 2) {
+                size_t working = mc.precision + guard;
+                MathContext wmc = {working + extra, RoundingMode::HALF_EVEN};
+                BigDecimal exponent = p.multiply(lnApprox(*this, working + extra), wmc);
+                BigDecimal approx = expApprox(exponent, working);
+                if (roundIfSafe(approx, working, mc, result)) break;
+                if (guard > 4 * mc.precision + 64) return approx.round(mc); // (almost) exact result
+            }
+            return result.lazyNormalize();
+        }
+
+        // *this = (-1)^negative * mantissa * 2^exponent, exactly
+        inline BigDecimal& assignBinary(bool negative, uint64_t mantissa, int64_t exponent) {
+            index = 0;
+            if (mantissa == 0) {
+                parent = 0;
+                return *this;
+            }
+            while (mantissa % 2 == 0) {
+                mantissa /= 2;
+                exponent++;
+            }
+            parent = mantissa;
+            if (exponent > 0) {
+                parent = parent.unsignedMultiplyPower(parent, 2, exponent);
+            } else if (exponent < 0) {
+                // mantissa * 2^-k = mantissa * 5^k / 10^k, mantissa is odd so there are no trailing zeros
+                parent = parent.unsignedMultiplyPower(parent, 5, -exponent);
+                index = -exponent;
+            }
+            parent.isNegative = negative;
+            return *this;
+        }
+
+        // |value| rounded to nearest even with `bits` bits of mantissa, the last place is never below 2^minExponent.
+        // returns the mantissa and sets exponent so that |value| ~ mantissa * 2^exponent
+        inline uint64_t roundBinary(int bits, int64_t minExponent, int64_t& exponent) const {
+            // estimate log2 |value| from the leading blocks
+            const auto& blocks = parent.number;
+            double leading = blocks[0];
+            int64_t decimalExponent = -int64_t(index);
+            if (blocks.size() >= 2) {
+                leading = leading * 1e9 + blocks[1];
+                decimalExponent += 9 * int64_t(blocks.size() - 2);
+            }
+            int64_t estimate = int64_t(std::floor(std::log2(leading) + decimalExponent * std::log2(10.0)));
+
+            // q = floor(|value| / 2^k) with bits + 1 to bits + 8 bits, the excess is dropped into a sticky bit
+            int64_t k = estimate - bits - 3;
+            while (true) {
+                std::pair<BigInteger, bool> qr; // floor(|coefficient| * 2^-k / 10^index), exact
+                if (k >= 0) {
+                    qr = parent.unsignedDividePower(parent, 10, index);
+                    auto shifted = parent.unsignedDividePower(qr.first, 2, k);
+                    qr = {shifted.first, qr.second && shifted.second};
+                } else {
+                    qr = parent.unsignedDividePower(parent.unsignedMultiplyPower(parent, 2, -k), 10, index);
+                }
+                uint64_t q = qr.first.number.size() <= 3 ? qr.first.toUint() : ~uint64_t(0);
+                int length = 0;
+                while (length < 64 && (q >> length) != 0) length++;
+                if (length < bits + 1) { // the estimate was off, retry
+                    k -= 2;
+                    continue;
+                }
+                if (length > bits + 8) {
+                    k += 2;
+                    continue;
+                }
+
+                int64_t lastPlace = std::max<int64_t>(k + length - bits, minExponent);
+                int64_t drop = lastPlace - k;
+                uint64_t mantissa = 0;
+                bool round = false;
+                bool sticky = !qr.second;
+                if (drop <= 64) {
+                    mantissa = drop == 64 ? 0 : q >> drop;
+                    round = (q >> (drop - 1)) & 1;
+                    sticky = sticky || (q & ((uint64_t(1) << (drop - 1)) - 1)) != 0;
+                } else {
+                    sticky = sticky || q != 0;
+                }
+                if (round && (sticky || mantissa % 2 == 1)) mantissa++;
+                exponent = lastPlace;
+                return mantissa;
+            }
+        }
+
     public:
+        // number of 9 digit blocks a coefficient may reach before trailing zeros get trimmed eagerly,
+        // set to 0 to normalize after every operation.
+        static inline size_t normalizeThreshold = 16;
+
         inline BigDecimal() { this->operator=(int64_t(0)); };
         inline BigDecimal(std::nullptr_t) : parent(nullptr){};
         inline BigDecimal(std::string val) { this->operator=(val); }
         inline BigDecimal(const char* val) { this->operator=(val); }
         inline BigDecimal(float val) { this->operator=(val); }
         inline BigDecimal(double val) { this->operator=(val); }
+        // unscaled * 10^-scale
+        inline BigDecimal(const BigInteger& unscaled, size_t scale) : parent(unscaled), index(scale) {}
         // template for integer types
         template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
         inline BigDecimal(T val) {
@@ -137,7 +495,7 @@ namespace estd {
                 if (base == 8) numDiv2 *= 3;
                 else if (base == 16)
                     numDiv2 *= 4;
-                *this += dec * BigDecimal("0.5").power(numDiv2);
+                *this += dec * BigDecimal(5, 1).power(numDiv2);
             }
 
             if (leftNum.size() == 0 && rightNum.size() == 0) throw std::invalid_argument("Cannot parse BigDecimal");
@@ -166,7 +524,7 @@ namespace estd {
 
             parent.isNegative = isNegative;
 
-            return trimTrailingZeros();
+            return lazyNormalize();
         }
         // template for integer types
         template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
@@ -176,16 +534,29 @@ namespace estd {
             return *this;
         }
 
+        // exact value of the ieee bits: mantissa * 2^exponent
         inline BigDecimal& operator=(double n) {
-            std::ostringstream ss;
-            ss << std::fixed << std::setprecision(200) << n;
-            return operator=(ss.str()).trimTrailingZeros();
+            if (!std::isfinite(n)) throw std::invalid_argument("Cannot convert a non finite value to BigDecimal");
+            uint64_t bits;
+            std::memcpy(&bits, &n, sizeof(bits));
+            int64_t exponent = (bits >> 52) & 0x7FF;
+            uint64_t mantissa = bits & ((uint64_t(1) << 52) - 1);
+            if (exponent == 0) exponent = 1; // subnormal
+            else
+                mantissa |= uint64_t(1) << 52;
+            return assignBinary(bits >> 63, mantissa, exponent - 1075);
         }
 
         inline BigDecimal& operator=(float n) {
-            std::ostringstream ss;
-            ss << std::fixed << std::setprecision(200) << n;
-            return operator=(ss.str()).trimTrailingZeros();
+            if (!std::isfinite(n)) throw std::invalid_argument("Cannot convert a non finite value to BigDecimal");
+            uint32_t bits;
+            std::memcpy(&bits, &n, sizeof(bits));
+            int64_t exponent = (bits >> 23) & 0xFF;
+            uint64_t mantissa = bits & ((uint32_t(1) << 23) - 1);
+            if (exponent == 0) exponent = 1; // subnormal
+            else
+                mantissa |= uint64_t(1) << 23;
+            return assignBinary(bits >> 31, mantissa, exponent - 150);
         }
 
         //Operations
@@ -194,7 +565,7 @@ namespace estd {
             size_t idx = alignDecimals(left, right);
             BigDecimal result = left.parent.operator+(right.parent);
             result.index = idx;
-            return result.trimTrailingZeros();
+            return result.lazyNormalize();
         }
 
         inline BigDecimal& operator+=(const BigDecimal& right) { return (*this) = (*this) + right; }
@@ -204,7 +575,7 @@ namespace estd {
             size_t idx = alignDecimals(left, right);
             BigDecimal result = left.parent.operator-(right.parent);
             result.index = idx;
-            return result.trimTrailingZeros();
+            return result.lazyNormalize();
         }
 
         inline BigDecimal& operator-=(const BigDecimal& right) { return (*this) = (*this) - right; }
@@ -213,7 +584,7 @@ namespace estd {
             const BigDecimal& left = *this;
             BigDecimal result = left.parent.operator*(right.parent);
             result.index = left.index + right.index;
-            return result.trimTrailingZeros();
+            return result.lazyNormalize();
         }
 
         inline BigDecimal& operator*=(const BigDecimal& right) { return (*this) = (*this) * right; }
@@ -223,7 +594,7 @@ namespace estd {
             alignDecimals(left, right);
             BigDecimal result = left.parent.operator/(right.parent);
             result.index = 0;
-            return result.trimTrailingZeros();
+            return result.lazyNormalize();
         }
 
         inline BigDecimal& operator/=(const BigDecimal& right) { return (*this) = (*this) / right; }
@@ -233,17 +604,220 @@ namespace estd {
             size_t idx = alignDecimals(left, right);
             BigDecimal result = left.parent.operator%(right.parent);
             result.index = idx;
-            return result.trimTrailingZeros();
+            return result.lazyNormalize();
         }
 
         inline BigDecimal& operator%=(const BigDecimal& right) { return (*this) = (*this) % right; }
 
         inline BigDecimal power(BigDecimal p) {
+            p.trimTrailingZeros();
             if (p.index != 0) throw std::invalid_argument("Power cannot be a fraction");
             const BigDecimal& left = *this;
             BigDecimal result = left.parent.power(p.parent);
             result.index = left.index * BigInteger(p).toUint();
-            return result.trimTrailingZeros();
+            return result.lazyNormalize();
+        }
+
+        // rounds, or pads with zeros, to exactly newScale digits after the decimal point
+        inline BigDecimal& setScale(size_t newScale, RoundingMode mode = RoundingMode::HALF_EVEN) {
+            if (index > newScale) roundDigits(index - newScale, mode);
+            else if (index < newScale)
+                addTrailZeros(newScale - index);
+            return *this;
+        }
+
+        // number of significant digits in the coefficient
+        inline size_t precision() const {
+            BigDecimal r = *this;
+            r.trimTrailingZeros();
+            return r.parent.getNumDigits();
+        }
+
+        inline size_t scale() const { return index; }
+
+        // rounds to mc.precision significant digits
+        inline BigDecimal& round(const MathContext& mc) {
+            if (mc.precision == 0 || parent.number.size() == 0) return *this;
+            size_t digits = parent.getNumDigits();
+            if (digits <= mc.precision) return *this;
+            roundDigits(digits - mc.precision, mc.roundingMode);
+            // rounding up may carry into a new digit (999 -> 1000), the extra digit is a zero
+            if (parent.getNumDigits() > mc.precision) {
+                roundDigits(parent.getNumDigits() - mc.precision, mc.roundingMode);
+            }
+            return *this;
+        }
+
+        inline BigDecimal add(const BigDecimal& right, const MathContext& mc) const {
+            BigDecimal result = *this + right;
+            return result.round(mc);
+        }
+
+        inline BigDecimal subtract(const BigDecimal& right, const MathContext& mc) const {
+            BigDecimal result = *this - right;
+            return result.round(mc);
+        }
+
+        inline BigDecimal multiply(const BigDecimal& right, const MathContext& mc) const {
+            BigDecimal result = *this * right;
+            return result.round(mc);
+        }
+
+        // computes the quotient to exactly mc.precision significant digits: the dividend is scaled once so
+        // that a single integer division yields precision + 1 digits, the remainder only decides the rounding.
+        inline BigDecimal divide(const BigDecimal& right, const MathContext& mc) const {
+            if (mc.precision == 0) throw std::invalid_argument("Division needs a MathContext with a precision");
+            if (right.parent.isZero()) throw std::invalid_argument("Cannot divide by zero");
+            if (parent.isZero()) return 0;
+
+            BigInteger dividend = parent;
+            BigInteger divisor = right.parent;
+            dividend.isNegative = false;
+            divisor.isNegative = false;
+
+            // quotient of an a digit number by a b digit number has at least a - b digits
+            int64_t shift = int64_t(mc.precision) + divisor.getNumDigits() - dividend.getNumDigits() + 1;
+            if (shift < 0) shift = 0;
+            dividend.number.insert(dividend.number.end(), shift / 9, 0);
+            dividend = dividend.unsignedMultiplySmall(dividend, BigInteger::powerOfTen(shift % 9).number[0]);
+
+            auto qr = dividend.unsignedDivide(dividend, divisor);
+
+            // quotient * 10^-(shift + index - right.index)
+            BigDecimal result = nullptr;
+            result.parent = qr.first;
+            result.parent.isNegative = parent.isNegative != right.parent.isNegative;
+            int64_t exponent = shift + int64_t(index) - int64_t(right.index);
+            if (exponent < 0) {
+                result.addTrailZeros(-exponent);
+                result.index = 0;
+            } else {
+                result.index = exponent;
+            }
+
+            size_t digits = result.parent.getNumDigits();
+            size_t drop = digits > mc.precision ? digits - mc.precision : 0;
+            result.roundDigits(drop, mc.roundingMode, !qr.second.isZero());
+            if (result.parent.getNumDigits() > mc.precision) {
+                result.roundDigits(result.parent.getNumDigits() - mc.precision, mc.roundingMode);
+            }
+            return result.lazyNormalize();
+        }
+
+        // repeated squaring carried out with a few guard digits, then rounded once to mc.precision
+        // (results may be off by one unit in the last place, like java's BigDecimal.pow(n, mc)).
+        // fractional powers are evaluated as exp(p * ln(x)) and need a positive base.
+        inline BigDecimal power(BigDecimal p, const MathContext& mc) const {
+            p.trimTrailingZeros();
+            if (p.index != 0) return powerFractional(p, mc);
+            if (mc.precision == 0) return BigDecimal(*this).power(p);
+
+            BigInteger exponent = p.parent;
+            bool negative = exponent.isNegative;
+            exponent.isNegative = false;
+
+            MathContext working = {mc.precision + exponent.getNumDigits() + 3, mc.roundingMode};
+            BigDecimal result = 1;
+            BigDecimal base = *this;
+            base.round(working);
+            while (!exponent.isZero()) {
+                auto qr = exponent.unsignedDivideSmall(exponent, 2);
+                if (qr.second == 1) result = result.multiply(base, working);
+                exponent = qr.first;
+                if (!exponent.isZero()) base = base.multiply(base, working);
+            }
+            if (negative) return BigDecimal(1).divide(result, mc);
+            return result.round(mc);
+        }
+
+        // square root rounded correctly to mc.precision digits, computed with a single integer square root
+        inline BigDecimal sqrt(const MathContext& mc) const {
+            if (mc.precision == 0) throw std::invalid_argument("Square root needs a MathContext with a precision");
+            if (parent.isNegative && !parent.isZero()) {
+                throw std::invalid_argument("Cannot take the square root of a negative number");
+            }
+            if (parent.isZero()) return 0;
+
+            // scale the coefficient to at least 2 * precision + 2 digits and an even number of decimals
+            size_t digits = parent.getNumDigits();
+            size_t shift = digits < 2 * mc.precision + 2 ? 2 * mc.precision + 2 - digits : 0;
+            if ((index + shift) % 2 == 1) shift++;
+
+            BigInteger scaled = parent;
+            scaled.number.insert(scaled.number.end(), shift / 9, 0);
+            scaled = scaled.unsignedMultiplySmall(scaled, BigInteger::powerOfTen(shift % 9).number[0]);
+            BigInteger root = scaled.unsignedSqrt(scaled);
+            bool exact = root * root == scaled;
+
+            BigDecimal result = nullptr;
+            result.parent = root;
+            result.index = (index + shift) / 2;
+            size_t rootDigits = root.getNumDigits();
+            result.roundDigits(rootDigits > mc.precision ? rootDigits - mc.precision : 0, mc.roundingMode, !exact);
+            if (result.parent.getNumDigits() > mc.precision) {
+                result.roundDigits(result.parent.getNumDigits() - mc.precision, mc.roundingMode);
+            }
+            return result.lazyNormalize();
+        }
+
+        inline BigDecimal exp(const MathContext& mc) const {
+            if (mc.precision == 0) throw std::invalid_argument("Exponent needs a MathContext with a precision");
+            if (parent.isZero()) return 1;
+
+            BigDecimal result = nullptr;
+            for (size_t guard = 8;; guard *= 2) {
+                BigDecimal approx = expApprox(*this, mc.precision + guard);
+                if (roundIfSafe(approx, mc.precision + guard, mc, result)) break;
+                if (guard > 4 * mc.precision + 64) return approx.round(mc); // (almost) exact result
+            }
+            return result.lazyNormalize();
+        }
+
+        // natural logarithm
+        inline BigDecimal ln(const MathContext& mc) const {
+            if (mc.precision == 0) throw std::invalid_argument("Logarithm needs a MathContext with a precision");
+            if (parent.isNegative || parent.isZero()) {
+                throw std::invalid_argument("Cannot take the logarithm of a non-positive number");
+            }
+            if (*this == 1) return 0;
+
+            BigDecimal result = nullptr;
+            for (size_t guard = 8;; guard *= 2) {
+                BigDecimal approx = lnApprox(*this, mc.precision + guard);
+                if (roundIfSafe(approx, mc.precision + guard, mc, result)) break;
+                if (guard > 4 * mc.precision + 64) return approx.round(mc); // (almost) exact result
+            }
+            return result.lazyNormalize();
+        }
+
+        inline static BigDecimal pi(const MathContext& mc) {
+            if (mc.precision == 0) throw std::invalid_argument("Pi needs a MathContext with a precision");
+
+            BigDecimal result = nullptr;
+            for (size_t guard = 8;; guard *= 2) {
+                size_t working = mc.precision + guard;
+                MathContext wmc = {working, RoundingMode::HALF_EVEN};
+                SeriesSplit split = chudnovskySplit(0, working / 14 + 2); // every term adds ~14.18 digits
+                BigDecimal approx = BigDecimal(10005).sqrt(wmc).multiply(BigDecimal(split.q * 426880), wmc);
+                approx = approx.divide(BigDecimal(split.t), wmc);
+                if (roundIfSafe(approx, working, mc, result)) break;
+            }
+            return result.lazyNormalize();
+        }
+
+        inline static BigDecimal e(const MathContext& mc) {
+            if (mc.precision == 0) throw std::invalid_argument("E needs a MathContext with a precision");
+
+            BigDecimal result = nullptr;
+            for (size_t guard = 8;; guard *= 2) {
+                size_t working = mc.precision + guard;
+                size_t terms = 2;
+                for (double digits = 0; digits < working + 2; terms++) digits += std::log10(double(terms));
+                SeriesSplit split = expSplit(1, 1, 0, terms);
+                BigDecimal approx = BigDecimal(split.t).divide(BigDecimal(split.q), {working, RoundingMode::HALF_EVEN});
+                if (roundIfSafe(approx, working, mc, result)) break;
+            }
+            return result.lazyNormalize();
         }
 
         inline BigDecimal operator++(int) {
@@ -325,17 +899,62 @@ namespace estd {
             }
         }
 
+        // correctly rounded (to nearest, ties to even) conversions, out of range values become infinity
+        inline double toDouble() const {
+            if (parent.number.size() == 0) return std::numeric_limits<double>::quiet_NaN();
+            if (parent.isZero()) return 0.0;
+            double sign = parent.isNegative ? -1.0 : 1.0;
+            if (adjustedExponent() > 309) return sign * std::numeric_limits<double>::infinity();
+            if (adjustedExponent() < -330) return sign * 0.0;
+            int64_t exponent;
+            uint64_t mantissa = roundBinary(53, -1074, exponent);
+            return sign * std::ldexp(double(mantissa), exponent);
+        }
+
+        inline float toFloat() const {
+            if (parent.number.size() == 0) return std::numeric_limits<float>::quiet_NaN();
+            if (parent.isZero()) return 0.0f;
+            float sign = parent.isNegative ? -1.0f : 1.0f;
+            if (adjustedExponent() > 39) return sign * std::numeric_limits<float>::infinity();
+            if (adjustedExponent() < -50) return sign * 0.0f;
+            int64_t exponent;
+            uint64_t mantissa = roundBinary(24, -149, exponent);
+            double result = std::ldexp(double(mantissa), exponent);
+            if (result > std::numeric_limits<float>::max()) return sign * std::numeric_limits<float>::infinity();
+            return sign * float(result);
+        }
+
+        inline explicit operator double() const { return toDouble(); }
+        inline explicit operator float() const { return toFloat(); }
+
         inline std::string toString() const {
             if (parent.number.size() == 0) return "nan";
-            std::string str = parent.toString();
+            BigDecimal r = *this;
+            r.trimTrailingZeros();
+
+            BigInteger magnitude = r.parent;
+            magnitude.isNegative = false;
+            std::string str = magnitude.toString();
 
-            if (index != 0) {
-                while (str.length() <= index) { str = std::string("0") + str; }
-                str = str.substr(0, str.length() - index) + "." + str.substr(str.length() - index);
+            if (r.index != 0) {
+                if (str.length() <= r.index) str = std::string(r.index - str.length() + 1, '0') + str;
+                str = str.substr(0, str.length() - r.index) + "." + str.substr(str.length() - r.index);
             }
+            if (r.parent.isNegative && !r.parent.isZero()) str = "-" + str;
             return str;
         }
 
+        // trims all trailing zeros so that equal values share one (coefficient, index) representation
+        inline BigDecimal& normalize() { return trimTrailingZeros(); }
+
+        inline size_t hash() const {
+            if (parent.number.size() == 0) return 0;
+            BigDecimal r = *this;
+            r.trimTrailingZeros();
+            size_t result = r.parent.hash();
+            return result ^ (std::hash<size_t>{}(r.index) + 0x9e3779b97f4a7c15ULL + (result << 6) + (result >> 2));
+        }
+
         inline BigInteger toBigInt() const {
             if (index == 0) {
                 return parent;
@@ -361,10 +980,30 @@ namespace estd {
 
     typedef BigDecimal BigDec;
 
+    inline namespace literals {
+        // 3.14159_bd or 1.5e-30_bd, the digits are parsed at compile time into blocks
+        template <char... Chars>
+        inline BigDecimal operator""_bd() {
+            static constexpr char str[] = {Chars...};
+            static constexpr size_t blocks = decimalblocks::literalBlocks(str, sizeof...(Chars));
+            static constexpr auto parsed = decimalblocks::parseLiteral<blocks>(str, sizeof...(Chars));
+            static_assert(parsed.isValid, "_bd needs a numeric literal");
+            BigInteger unscaled = BigInteger::fromBlocks(parsed.blocks + parsed.offset, blocks - parsed.offset);
+            if constexpr (parsed.exponent > 0) return BigDecimal(unscaled * BigInteger::powerOfTen(parsed.exponent), 0);
+            else
+                return BigDecimal(unscaled, -parsed.exponent);
+        }
+    } // namespace literals
+
     inline BigInteger::operator BigDecimal() {
         BigDecimal r;
         r.parent.number = number;
         r.parent.isNegative = isNegative;
         return r;
     }
-} // namespace estd
\ No newline at end of file
+} // namespace estd
+
+template <>
+struct std::hash<estd::BigDecimal> {
+    inline size_t operator()(const estd::BigDecimal& val) const { return val.hash(); }
+};
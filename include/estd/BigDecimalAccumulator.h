@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <estd/BigDecimal.h>
+#include <estd/BigInteger.h>
+#include <vector>
+
+namespace estd {
+    // Exact running sum of BigDecimals without a BigDecimal per add. A value with scale s is
+    // coefficient * 10^t * base^-q with q = ceil(s / 9) and t = 9q - s, so the values are kept in nine partial
+    // sums by t. Each one is a fixed point number of 64 bit columns, one per block position relative to the
+    // point, and adding a value adds its blocks into the columns. Carries are deferred until a column could
+    // overflow, positive and negative values are summed separately (like BigIntegerArray::sum) and only
+    // result() builds the total. Accumulators of parallel shards combine exactly with merge().
+    class BigDecimalAccumulator {
+    protected:
+        // little endian columns, index 0 is the block fractionBlocks places right of the point
+        struct Partial {
+            std::vector<uint64_t> positive;
+            std::vector<uint64_t> negative;
+            size_t fractionBlocks = 0;
+
+            // room for n columns starting fraction blocks right of the point, returns the index of the first
+            inline size_t reserve(size_t fraction, size_t n) {
+                if (fraction > fractionBlocks) {
+                    positive.insert(positive.begin(), fraction - fractionBlocks, 0);
+                    negative.insert(negative.begin(), fraction - fractionBlocks, 0);
+                    fractionBlocks = fraction;
+                }
+                size_t first = fractionBlocks - fraction;
+                if (positive.size() < first + n) {
+                    positive.resize(first + n, 0);
+                    negative.resize(first + n, 0);
+                }
+                return first;
+            }
+
+            // every column below base again, the carry out of the top grows the columns
+            inline void carry() {
+                for (auto* columns : {&positive, &negative}) {
+                    uint64_t carry = 0;
+                    for (auto& column : *columns) {
+                        uint64_t value = column % decimalblocks::base + carry;
+                        carry = column / decimalblocks::base + value / decimalblocks::base;
+                        column = value % decimalblocks::base;
+                    }
+                    for (; carry != 0; carry /= decimalblocks::base) columns->push_back(carry % decimalblocks::base);
+                }
+                size_t columns = std::max(positive.size(), negative.size());
+                positive.resize(columns, 0);
+                negative.resize(columns, 0);
+            }
+        };
+
+        // a column takes 2^64 / 10^9 (about 1.8 * 10^10) additions, merge() may add two uncarried partials
+        static constexpr uint64_t carryInterval = uint64_t(1) << 33;
+
+        Partial partials[9];
+        uint64_t pending = 0; // additions since the last carry
+        uint64_t count = 0;
+
+        inline void carryAll() {
+            for (auto& partial : partials) partial.carry();
+            pending = 0;
+        }
+
+        // carried columns as an integer
+        inline static BigInteger columnsValue(const std::vector<uint64_t>& columns) {
+            if (columns.empty()) return 0;
+            std::vector<uint32_t> blocks(columns.size());
+            for (size_t i = 0; i < columns.size(); i++) blocks[columns.size() - 1 - i] = uint32_t(columns[i]);
+            return BigInteger::fromBlocks(blocks.data(), blocks.size());
+        }
+
+        inline void addSigned(const BigDecimal& value, bool flip) {
+            const BlockBuffer& blocks = value.parent.number;
+            if (blocks.size() == 0) throw std::invalid_argument("Cannot add nan to an accumulator");
+            count++;
+            if (value.parent.isZero()) return;
+
+            size_t fraction = (value.index + 8) / 9;
+            Partial& partial = partials[fraction * 9 - value.index];
+            size_t n = blocks.size();
+            size_t first = partial.reserve(fraction, n);
+            uint64_t* target = (value.parent.isNegative != flip ? partial.negative : partial.positive).data() + first;
+            for (size_t k = 0; k < n; k++) target[k] += blocks[n - 1 - k];
+            if (++pending == carryInterval) carryAll();
+        }
+
+    public:
+        inline BigDecimalAccumulator() {}
+
+        inline void add(const BigDecimal& value) { addSigned(value, false); }
+        inline void subtract(const BigDecimal& value) { addSigned(value, true); }
+
+        inline BigDecimalAccumulator& operator+=(const BigDecimal& value) {
+            addSigned(value, false);
+            return *this;
+        }
+        inline BigDecimalAccumulator& operator-=(const BigDecimal& value) {
+            addSigned(value, true);
+            return *this;
+        }
+
+        // adds the values of other, the totals of shards summed in parallel merge into the total of all values
+        inline BigDecimalAccumulator& merge(const BigDecimalAccumulator& other) {
+            for (size_t t = 0; t < 9; t++) {
+                Partial& partial = partials[t];
+                const Partial& right = other.partials[t];
+                size_t offset = partial.reserve(right.fractionBlocks, right.positive.size());
+                for (size_t i = 0; i < right.positive.size(); i++) {
+                    partial.positive[offset + i] += right.positive[i];
+                    partial.negative[offset + i] += right.negative[i];
+                }
+            }
+            count += other.count;
+            pending += other.pending;
+            if (pending >= carryInterval) carryAll();
+            return *this;
+        }
+
+        // number of values added or subtracted
+        inline uint64_t size() const { return count; }
+
+        inline void clear() { *this = BigDecimalAccumulator(); }
+
+        // the exact total, trailing zeros removed
+        inline BigDecimal result() const {
+            BigDecimal total = 0;
+            for (size_t t = 0; t < 9; t++) {
+                Partial partial = partials[t];
+                partial.carry();
+                BigInteger value = columnsValue(partial.positive) - columnsValue(partial.negative);
+                if (!value.isZero()) total += BigDecimal(value, partial.fractionBlocks * 9 - t);
+            }
+            return total.normalize();
+        }
+    };
+} // namespace estd
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <estd/BigDecimal.h>
+#include <estd/BigIntegerArray.h>
+#include <string>
+#include <vector>
+
+namespace estd {
+    // Column of decimals sharing one scale (like a SQL DECIMAL(p, s) column): the values are stored as their
+    // unscaled integers in a BigIntegerArray, so the batch kernels are the integer ones.
+    class BigDecimalArray {
+    protected:
+        BigIntegerArray unscaled;
+        size_t columnScale = 0;
+
+        inline BigDecimalArray(BigIntegerArray values, size_t scale)
+            : unscaled(std::move(values)), columnScale(scale) {}
+
+        // the digits of a plain decimal string with the point moved columnScale places right, empty if the
+        // string is not a plain decimal
+        inline std::string unscaledDigits(const std::string& str) const {
+            size_t point = str.find('.');
+            size_t decimals = point == std::string::npos ? 0 : str.size() - point - 1;
+            if (decimals > columnScale) throw std::invalid_argument("Value has more decimals than the column scale");
+            std::string digits = point == std::string::npos ? str : str.substr(0, point) + str.substr(point + 1);
+            size_t start = !digits.empty() && digits[0] == '-';
+            if (digits.size() == start) return "";
+            for (size_t i = start; i < digits.size(); i++) {
+                if (digits[i] < '0' || digits[i] > '9') return "";
+            }
+            return digits + std::string(columnScale - decimals, '0');
+        }
+
+    public:
+        inline explicit BigDecimalArray(size_t scale = 0) : columnScale(scale) {}
+
+        inline size_t size() const { return unscaled.size(); }
+        inline size_t scale() const { return columnScale; }
+
+        // lossless, throws if value has more than scale() digits after the point
+        inline void push_back(BigDecimal value) {
+            value.normalize();
+            if (value.index > columnScale) throw std::invalid_argument("Value has more decimals than the column scale");
+            value.setScale(columnScale);
+            unscaled.push_back(value.parent);
+        }
+
+        inline BigDecimal operator[](size_t i) const { return BigDecimal(unscaled[i], columnScale); }
+
+        // parses every string into a column with the given scale, in parallel for large inputs
+        inline static BigDecimalArray parseAll(const std::vector<std::string>& strings, size_t scale) {
+            BigDecimalArray shape(scale);
+            std::vector<BigDecimalArray> parts(BigInteger::executor ? 256 : 1, shape);
+            size_t chunks = BigIntegerArray::forChunks(strings.size(), [&](size_t begin, size_t end, size_t chunk) {
+                for (size_t i = begin; i < end; i++) {
+                    std::string digits = shape.unscaledDigits(strings[i]);
+                    if (digits.empty()) parts[chunk].push_back(BigDecimal(strings[i]));
+                    else
+                        parts[chunk].unscaled.appendParsed(digits);
+                }
+            });
+            for (size_t c = 0; c < chunks; c++) shape.unscaled.append(parts[c].unscaled);
+            return shape;
+        }
+
+        // always prints scale() digits after the point
+        inline std::vector<std::string> toStrings() const {
+            std::vector<std::string> result = unscaled.toStrings();
+            if (columnScale == 0) return result;
+            for (auto& str : result) {
+                bool negative = str[0] == '-';
+                size_t digits = str.size() - negative;
+                if (digits <= columnScale) str.insert(negative, columnScale - digits + 1, '0');
+                str.insert(str.size() - columnScale, ".");
+            }
+            return result;
+        }
+
+        inline BigDecimal sum() const { return BigDecimal(unscaled.sum(), columnScale); }
+
+        inline BigDecimalArray mulScalar(const BigInteger& factor) const {
+            return BigDecimalArray(unscaled.mulScalar(factor), columnScale);
+        }
+
+        // -1, 0 or 1 per element as it compares to threshold
+        inline std::vector<int8_t> compare(BigDecimal threshold) const {
+            threshold.normalize();
+            if (threshold.index <= columnScale) return unscaled.compare(threshold.setScale(columnScale).parent);
+
+            // the threshold has more decimals than the column: compare against it rounded down, an element
+            // equal to that lies below the threshold
+            threshold.setScale(columnScale, RoundingMode::FLOOR);
+            std::vector<int8_t> result = unscaled.compare(threshold.parent);
+            for (auto& c : result) {
+                if (c == 0) c = -1;
+            }
+            return result;
+        }
+    };
+} // namespace estd
@@ -0,0 +1,499 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <estd/BigBinaryInteger.h>
+#include <estd/BigDecimal.h>
+#include <estd/BigInteger.h>
+#include <string>
+
+namespace estd {
+    // Binary floating point number (-1)^isNegative * mantissa * 2^exponent with a mantissa of at most precision
+    // bits. Aligning two values is a shift and rounding drops low bits, so unlike BigDecimal a value never grows
+    // past its precision. + - * / and sqrt round the exact result once (ties to even) to the larger precision of
+    // the operands. The mantissa is kept odd so every value has a single representation.
+    class BigFloat {
+    public:
+        // precision in bits of values built from integers, doubles and strings, 256 bits are about 77 digits
+        inline static size_t defaultPrecision = 256;
+
+    protected:
+        BigBinaryInteger mantissa; // magnitude, odd or zero
+        int64_t exponent = 0;
+        bool isNegative = false;
+        size_t precision = defaultPrecision;
+
+        inline static bool roundUp(RoundingMode mode, bool negative, bool half, bool sticky, bool odd) {
+            switch (mode) {
+                case RoundingMode::UP: return half || sticky;
+                case RoundingMode::DOWN: return false;
+                case RoundingMode::CEILING: return !negative && (half || sticky);
+                case RoundingMode::FLOOR: return negative && (half || sticky);
+                case RoundingMode::HALF_UP: return half;
+                case RoundingMode::HALF_DOWN: return half && sticky;
+                case RoundingMode::HALF_EVEN: return half && (sticky || odd);
+            }
+            return false;
+        }
+
+        // true when any of the lowest `bits` bits of x is set
+        inline static bool anyLowBits(const BigBinaryInteger& x, size_t bits) {
+            size_t full = std::min(bits / 64, x.limbs.size());
+            for (size_t i = 0; i < full; i++) {
+                if (x.limbs[i] != 0) return true;
+            }
+            if (full == x.limbs.size() || bits % 64 == 0) return false;
+            return (x.limbs[full] & ((uint64_t(1) << (bits % 64)) - 1)) != 0;
+        }
+
+        inline static size_t trailingZeros(const BigBinaryInteger& x) {
+            size_t result = 0;
+            for (uint64_t limb : x.limbs) {
+                if (limb != 0) {
+                    while ((limb & 1) == 0) {
+                        limb >>= 1;
+                        result++;
+                    }
+                    return result;
+                }
+                result += 64;
+            }
+            return 0;
+        }
+
+        // stores magnitude * 2^shift rounded to precision bits, sticky signals nonzero bits below magnitude
+        inline BigFloat& assign(
+            bool negative, BigBinaryInteger magnitude, int64_t shift, RoundingMode mode, bool sticky = false
+        ) {
+            size_t length = magnitude.bitLength();
+            if (sticky && length <= precision) { // make room for a rounding bit below the last place
+                size_t widen = precision + 2 - length;
+                magnitude <<= widen;
+                shift -= widen;
+                length += widen;
+            }
+            if (length > precision) {
+                size_t drop = length - precision;
+                bool half = magnitude.testBit(drop - 1);
+                sticky = sticky || anyLowBits(magnitude, drop - 1);
+                magnitude >>= drop;
+                shift += drop;
+                if (roundUp(mode, negative, half, sticky, magnitude.testBit(0))) magnitude += 1;
+            }
+
+            // rounding up may carry into a new bit (0111 -> 1000), stripping the zeros takes it back
+            size_t zeros = trailingZeros(magnitude);
+            mantissa = magnitude >> zeros;
+            exponent = mantissa.isZero() ? 0 : shift + zeros;
+            isNegative = negative && !mantissa.isZero();
+            return *this;
+        }
+
+        // stores num / den * 2^shift rounded to precision bits, num and den are magnitudes and den is not zero
+        inline BigFloat& assignQuotient(
+            bool negative, const BigBinaryInteger& num, const BigBinaryInteger& den, int64_t shift, RoundingMode mode
+        ) {
+            if (num.isZero()) return assign(false, num, 0, mode);
+            // the quotient of an a bit by a b bit number has at least a - b bits, two more decide the rounding
+            int64_t extra = std::max<int64_t>(int64_t(precision) + 2 + den.bitLength() - num.bitLength(), 0);
+            auto qr = BigBinaryInteger::divideMagnitude(BigBinaryInteger::shiftLeft(num.limbs, extra), den.limbs);
+            bool sticky = !BigBinaryInteger(qr.second, false).isZero();
+            return assign(negative, BigBinaryInteger(qr.first, false), shift - extra, mode, sticky);
+        }
+
+        // 5^k by repeated squaring, every product truncated to `bits` bits. Each truncation and each squaring of
+        // an error grows the relative error by less than 2^(1 - bits) per step, so 5^k lies in
+        // [power, power + error] * 2^shift while steps * 2^(1 - bits) <= 1
+        inline static BigBinaryInteger powerOfFive(uint64_t k, size_t bits, int64_t& shift, uint64_t& error) {
+            BigBinaryInteger power = 1;
+            uint64_t steps = 0;
+            shift = 0;
+            auto truncate = [&] {
+                size_t length = power.bitLength();
+                if (length <= bits) return;
+                power >>= length - bits;
+                shift += length - bits;
+                steps++;
+            };
+            for (int bit = 63 - binlimbs::countLeadingZeros(k); bit >= 0; bit--) {
+                power = power * power;
+                shift *= 2;
+                steps *= 2;
+                truncate();
+                if ((k >> bit) & 1) {
+                    power = power * BigBinaryInteger(5);
+                    truncate();
+                }
+            }
+            // (1 + 2^(1 - bits))^steps <= 1 + steps * 2^(2 - bits) and power < 2^bits
+            error = 4 * steps + 1;
+            return power;
+        }
+
+        // coefficient * 10^decimalExponent rounded, with 10^k = 5^k * 2^k. A power of five no longer than the
+        // working precision is exact, a larger one is evaluated to precision plus guard bits: when both ends of
+        // its error bound round the same way so does the exact value, otherwise the guard doubles (Ziv's loop)
+        inline BigFloat& assignDecimal(const BigInteger& coefficient, int64_t decimalExponent, RoundingMode mode) {
+            BigBinaryInteger magnitude(coefficient);
+            bool negative = magnitude.isNegative;
+            magnitude.isNegative = false;
+            uint64_t k = decimalExponent < 0 ? uint64_t(0) - uint64_t(decimalExponent) : uint64_t(decimalExponent);
+            if (magnitude.isZero() || k == 0) return assign(negative, magnitude, 0, mode);
+
+            int64_t shift;
+            uint64_t error;
+            for (size_t guard = 96 - binlimbs::countLeadingZeros(k);; guard *= 2) {
+                size_t bits = precision + guard;
+                if (k / 3 * 7 + 3 <= bits) break; // 5^k has at most 2.33 * k bits
+
+                BigBinaryInteger power = powerOfFive(k, bits, shift, error);
+                BigBinaryInteger upper = power + BigBinaryInteger(error);
+                BigFloat low, high;
+                low.precision = high.precision = precision;
+                if (decimalExponent > 0) {
+                    low.assign(negative, magnitude * power, shift + int64_t(k), mode);
+                    high.assign(negative, magnitude * upper, shift + int64_t(k), mode);
+                } else {
+                    low.assignQuotient(negative, magnitude, upper, -int64_t(k) - shift, mode);
+                    high.assignQuotient(negative, magnitude, power, -int64_t(k) - shift, mode);
+                }
+                if (low == high) return *this = low;
+            }
+
+            BigBinaryInteger power = powerOfFive(k, SIZE_MAX, shift, error);
+            if (decimalExponent > 0) return assign(negative, magnitude * power, int64_t(k), mode);
+            return assignQuotient(negative, magnitude, power, -int64_t(k), mode);
+        }
+
+        // floor(num * 2^shift / den) of magnitudes, sticky tells whether the division left a remainder
+        inline static BigBinaryInteger floorScaled(
+            const BigBinaryInteger& num, const BigBinaryInteger& den, int64_t shift, bool& sticky
+        ) {
+            BigBinaryInteger a(shift > 0 ? BigBinaryInteger::shiftLeft(num.limbs, shift) : num.limbs, false);
+            BigBinaryInteger b(shift < 0 ? BigBinaryInteger::shiftLeft(den.limbs, -shift) : den.limbs, false);
+            auto qr = BigBinaryInteger::divideMagnitude(a.limbs, b.limbs);
+            sticky = !BigBinaryInteger(qr.second, false).isZero();
+            return BigBinaryInteger(qr.first, false);
+        }
+
+        // the value rounded to digits significant digits as coefficient * 10^decimalExponent, the coefficient
+        // carries the sign and may end in zeros. The inverse of assignDecimal: |value| / 10^q with q chosen so
+        // the quotient has a few digits more than needed is bounded with a truncated 5^|q|, and the guard
+        // doubles until both bounds round the same way. Only a power no longer than the working precision is
+        // evaluated exactly, so the cost does not grow with the exponent
+        inline BigInteger roundDecimal(size_t digits, RoundingMode mode, int64_t& decimalExponent) const {
+            // 10^a <= |value| < 10^(a + 1) with a - estimate in [0, 3]: for 2^x <= |value| the estimate is
+            // floor(x * c / 2^64) - 1 with c = floor(log10(2) * 2^64), which is at most 1 off floor(x * log10(2))
+            int64_t x = top() - 1;
+            int64_t estimate = int64_t((__int128(x) * __int128(uint64_t(0x4d104d427de7fbcc))) >> 64) - 1;
+            int64_t q = estimate - int64_t(digits);
+            uint64_t k = q < 0 ? uint64_t(0) - uint64_t(q) : uint64_t(q);
+            decimalExponent = q;
+
+            // |value| / 10^q for 5^k = power * 2^shift has digits + 1 to digits + 4 digits, the lowest are dropped
+            auto rounded = [&](const BigBinaryInteger& power, int64_t shift) {
+                bool sticky;
+                BigBinaryInteger whole = q >= 0 ? floorScaled(mantissa, power, exponent - q - shift, sticky)
+                                                : floorScaled(mantissa * power, 1, exponent - q + shift, sticky);
+                whole.isNegative = isNegative;
+                BigDecimal result(BigInteger(whole), 0);
+                result.roundDigits(result.parent.getNumDigits() - digits, mode, sticky);
+                return result.parent;
+            };
+
+            int64_t shift;
+            uint64_t error;
+            size_t working = (digits + 4) * 3322 / 1000 + 2; // bits of the quotient
+            for (size_t guard = 96 - binlimbs::countLeadingZeros(k);; guard *= 2) {
+                size_t bits = working + guard;
+                if (k / 3 * 7 + 3 <= bits) break; // 5^k has at most 2.33 * k bits
+
+                BigBinaryInteger power = powerOfFive(k, bits, shift, error);
+                BigInteger low = rounded(power, shift), high = rounded(power + BigBinaryInteger(error), shift);
+                if (low == high) return low;
+            }
+            BigBinaryInteger power = powerOfFive(k, SIZE_MAX, shift, error);
+            return rounded(power, shift);
+        }
+
+        // coefficient * 10^decimalExponent, trailing zeros removed
+        inline static BigDecimal decimalValue(const BigInteger& coefficient, int64_t decimalExponent) {
+            if (decimalExponent < 0) return BigDecimal(coefficient, -decimalExponent).normalize();
+            return BigDecimal(coefficient * BigInteger::powerOfTen(decimalExponent), 0).normalize();
+        }
+
+        // floor(sqrt(n)) by newton's method from above
+        inline static BigBinaryInteger isqrt(const BigBinaryInteger& n) {
+            BigBinaryInteger x = BigBinaryInteger(1) << ((n.bitLength() + 1) / 2);
+            while (true) {
+                BigBinaryInteger y = (x + n / x) >> 1;
+                if (y >= x) return x;
+                x = y;
+            }
+        }
+
+        // 2^(top() - 1) <= |value| < 2^top()
+        inline int64_t top() const { return exponent + int64_t(mantissa.bitLength()); }
+
+        inline static void checkPrecision(size_t bits) {
+            if (bits == 0) throw std::invalid_argument("Precision must be at least one bit");
+        }
+
+        inline BigFloat addSigned(const BigFloat& right, bool flip) const {
+            BigFloat result;
+            result.precision = std::max(precision, right.precision);
+            bool rightNegative = right.isNegative != flip;
+            if (right.mantissa.isZero()) return result.assign(isNegative, mantissa, exponent, RoundingMode::HALF_EVEN);
+            if (mantissa.isZero()) {
+                return result.assign(rightNegative, right.mantissa, right.exponent, RoundingMode::HALF_EVEN);
+            }
+
+            bool leftLarger = top() >= right.top();
+            const BigFloat& large = leftLarger ? *this : right;
+            const BigFloat& small = leftLarger ? right : *this;
+            bool largeNegative = leftLarger ? isNegative : rightNegative;
+            bool smallNegative = leftLarger ? rightNegative : isNegative;
+
+            // when the small operand lies below the last place of the large one widened to precision + 3 bits,
+            // it only moves the sum off that grid and a single unit in the last place rounds the same way
+            int64_t widen = std::max<int64_t>(int64_t(result.precision) + 3 - large.mantissa.bitLength(), 2);
+            if (small.top() <= large.exponent - widen) {
+                BigBinaryInteger shifted = large.mantissa << widen;
+                shifted = largeNegative == smallNegative ? shifted + 1 : shifted - 1;
+                return result.assign(largeNegative, shifted, large.exponent - widen, RoundingMode::HALF_EVEN);
+            }
+
+            int64_t low = std::min(exponent, right.exponent);
+            BigBinaryInteger a = large.mantissa << (large.exponent - low);
+            BigBinaryInteger b = small.mantissa << (small.exponent - low);
+            RoundingMode mode = RoundingMode::HALF_EVEN;
+            if (largeNegative == smallNegative) return result.assign(largeNegative, a + b, low, mode);
+            if (a >= b) return result.assign(largeNegative, a - b, low, mode);
+            return result.assign(smallNegative, b - a, low, mode);
+        }
+
+    public:
+        inline BigFloat() {}
+        // template for integer types
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigFloat(T val) {
+            BigBinaryInteger magnitude(val);
+            magnitude.isNegative = false;
+            assign(val < 0, magnitude, 0, RoundingMode::HALF_EVEN);
+        }
+        // exact when the precision has at least 53 bits
+        inline BigFloat(double val) {
+            if (!std::isfinite(val)) throw std::invalid_argument("Cannot convert nan or infinity to BigFloat");
+            int binaryExponent;
+            double fraction = std::frexp(std::fabs(val), &binaryExponent);
+            uint64_t bits = uint64_t(std::ldexp(fraction, 53));
+            assign(val < 0, BigBinaryInteger(bits), int64_t(binaryExponent) - 53, RoundingMode::HALF_EVEN);
+        }
+        inline explicit BigFloat(
+            const BigInteger& val, size_t bits = defaultPrecision, RoundingMode mode = RoundingMode::HALF_EVEN
+        ) {
+            checkPrecision(bits);
+            precision = bits;
+            assignDecimal(val, 0, mode);
+        }
+        inline explicit BigFloat(
+            const BigDecimal& val, size_t bits = defaultPrecision, RoundingMode mode = RoundingMode::HALF_EVEN
+        ) {
+            checkPrecision(bits);
+            precision = bits;
+            assignDecimal(val.parent, -int64_t(val.index), mode);
+        }
+        // anything BigDecimal parses, optionally followed by a decimal exponent ("6.02214076e23", "1E-300")
+        inline BigFloat(const std::string& str, size_t bits = defaultPrecision) {
+            checkPrecision(bits);
+            precision = bits;
+            size_t marker = str.find_first_of("eE");
+            BigDecimal coefficient(str.substr(0, marker));
+            int64_t decimalExponent = 0;
+            if (marker != std::string::npos) {
+                std::string digits = str.substr(marker + 1);
+                size_t start = !digits.empty() && (digits[0] == '-' || digits[0] == '+');
+                if (digits.size() == start || digits.size() - start > 18) {
+                    throw std::invalid_argument("Cannot parse BigFloat exponent");
+                }
+                for (size_t i = start; i < digits.size(); i++) {
+                    if (digits[i] < '0' || digits[i] > '9') {
+                        throw std::invalid_argument("Cannot parse BigFloat exponent");
+                    }
+                    decimalExponent = decimalExponent * 10 + (digits[i] - '0');
+                }
+                if (digits[0] == '-') decimalExponent = -decimalExponent;
+            }
+            assignDecimal(coefficient.parent, decimalExponent - int64_t(coefficient.index), RoundingMode::HALF_EVEN);
+        }
+        inline BigFloat(const char* str, size_t bits = defaultPrecision) : BigFloat(std::string(str), bits) {}
+
+        inline size_t getPrecision() const { return precision; }
+
+        // rounds to bits bits, a larger precision only affects later results
+        inline BigFloat& setPrecision(size_t bits, RoundingMode mode = RoundingMode::HALF_EVEN) {
+            checkPrecision(bits);
+            precision = bits;
+            return assign(isNegative, mantissa, exponent, mode);
+        }
+
+        inline bool isZero() const { return mantissa.isZero(); }
+
+        // -1, 0 or 1
+        inline int sign() const { return mantissa.isZero() ? 0 : isNegative ? -1 : 1; }
+
+        //Operations
+        inline BigFloat operator-() const {
+            BigFloat result = *this;
+            result.isNegative = !isNegative && !mantissa.isZero();
+            return result;
+        }
+
+        inline BigFloat operator+(const BigFloat& right) const { return addSigned(right, false); }
+        inline BigFloat operator-(const BigFloat& right) const { return addSigned(right, true); }
+
+        inline BigFloat operator*(const BigFloat& right) const {
+            BigFloat result;
+            result.precision = std::max(precision, right.precision);
+            return result.assign(
+                isNegative != right.isNegative, mantissa * right.mantissa, exponent + right.exponent,
+                RoundingMode::HALF_EVEN
+            );
+        }
+
+        inline BigFloat operator/(const BigFloat& right) const {
+            if (right.mantissa.isZero()) throw std::invalid_argument("Cannot divide by zero");
+            BigFloat result;
+            result.precision = std::max(precision, right.precision);
+            return result.assignQuotient(
+                isNegative != right.isNegative, mantissa, right.mantissa, exponent - right.exponent,
+                RoundingMode::HALF_EVEN
+            );
+        }
+
+        inline BigFloat& operator+=(const BigFloat& right) { return (*this) = (*this) + right; }
+        inline BigFloat& operator-=(const BigFloat& right) { return (*this) = (*this) - right; }
+        inline BigFloat& operator*=(const BigFloat& right) { return (*this) = (*this) * right; }
+        inline BigFloat& operator/=(const BigFloat& right) { return (*this) = (*this) / right; }
+
+        // this * 2^shift, exact
+        inline BigFloat scaleBinary(int64_t shift) const {
+            BigFloat result = *this;
+            if (!mantissa.isZero()) result.exponent += shift;
+            return result;
+        }
+
+        // correctly rounded square root: the mantissa is widened to at least 2 * precision + 4 bits with an even
+        // exponent, one integer square root then gives precision + 2 bits and its remainder the sticky bit
+        inline BigFloat sqrt(RoundingMode mode = RoundingMode::HALF_EVEN) const {
+            if (isNegative) throw std::invalid_argument("Cannot take the square root of a negative number");
+            if (mantissa.isZero()) return *this;
+            size_t length = mantissa.bitLength();
+            int64_t widen = std::max<int64_t>(2 * int64_t(precision) + 4 - int64_t(length), 0);
+            if ((exponent - widen) % 2 != 0) widen++;
+            BigBinaryInteger scaled = mantissa << widen;
+            BigBinaryInteger root = isqrt(scaled);
+            BigFloat result;
+            result.precision = precision;
+            return result.assign(false, root, (exponent - widen) / 2, mode, root * root != scaled);
+        }
+
+        // -1, 0 or 1
+        inline int compare(const BigFloat& right) const {
+            int leftSign = sign(), rightSign = right.sign();
+            if (leftSign != rightSign) return leftSign < rightSign ? -1 : 1;
+            if (leftSign == 0) return 0;
+            int magnitude = 0;
+            if (top() != right.top()) {
+                magnitude = top() < right.top() ? -1 : 1;
+            } else {
+                int64_t low = std::min(exponent, right.exponent);
+                BigBinaryInteger a = mantissa << (exponent - low), b = right.mantissa << (right.exponent - low);
+                magnitude = a < b ? -1 : a > b ? 1 : 0;
+            }
+            return leftSign * magnitude;
+        }
+
+        // values are equal regardless of their precision
+        inline bool operator==(const BigFloat& right) const {
+            return isNegative == right.isNegative && exponent == right.exponent && mantissa == right.mantissa;
+        }
+        inline bool operator!=(const BigFloat& right) const { return !(*this == right); }
+        inline bool operator<(const BigFloat& right) const { return compare(right) < 0; }
+        inline bool operator>(const BigFloat& right) const { return compare(right) > 0; }
+        inline bool operator<=(const BigFloat& right) const { return compare(right) <= 0; }
+        inline bool operator>=(const BigFloat& right) const { return compare(right) >= 0; }
+
+        // exact, a negative binary exponent k needs k digits after the decimal point
+        inline BigDecimal toBigDecimal() const {
+            BigInteger magnitude = mantissa;
+            if (exponent >= 0) magnitude = BigInteger(mantissa << exponent);
+            else
+                magnitude *= BigInteger(5).power(-exponent);
+            if (isNegative) magnitude = -magnitude;
+            return BigDecimal(magnitude, exponent < 0 ? -exponent : 0);
+        }
+
+        // rounded to mc.precision significant digits, only a value of at least 10^mc.precision needs zeros
+        // in front of the point and their number grows with the exponent
+        inline BigDecimal toBigDecimal(const MathContext& mc) const {
+            if (mc.precision == 0 || mantissa.isZero()) return toBigDecimal();
+            int64_t decimalExponent;
+            BigInteger coefficient = roundDecimal(mc.precision, mc.roundingMode, decimalExponent);
+            return decimalValue(coefficient, decimalExponent);
+        }
+
+        // correctly rounded (to nearest, ties to even), out of range values become infinity
+        inline double toDouble() const {
+            if (mantissa.isZero()) return 0.0;
+            double result = 0.0;
+            // subnormals keep their last place at 2^-1074, below it only values above 2^-1075 round up
+            int64_t bits = std::min<int64_t>(53, top() + 1074);
+            if (bits > 0) {
+                BigFloat r = *this;
+                r.setPrecision(bits);
+                result = r.top() > 1024 ? HUGE_VAL : std::ldexp(double(r.mantissa.getLimb(0)), int(r.exponent));
+            } else if (bits == 0 && !(mantissa == 1)) {
+                result = std::ldexp(1.0, -1074);
+            }
+            return isNegative ? -result : result;
+        }
+
+        inline explicit operator double() const { return toDouble(); }
+
+        inline friend std::ostream& operator<<(std::ostream& out, const BigFloat& right) {
+            return out << right.toString();
+        }
+
+        // decimal string with enough significant digits to read back the same value (digits == 0), or digits.
+        // Like printf's %g the value is written plainly when its leading digit lies between 10^-5 and
+        // 10^(digits - 1), and in exponent notation ("1.5e200000", "-2e-7") otherwise
+        inline std::string toString(size_t digits = 0) const {
+            if (digits == 0) digits = precision * 30103 / 100000 + 2; // ceil(precision * log10(2)) + 1
+            if (mantissa.isZero()) return "0";
+            int64_t decimalExponent;
+            BigInteger coefficient = roundDecimal(digits, RoundingMode::HALF_EVEN, decimalExponent);
+            int64_t leading = decimalExponent + int64_t(coefficient.getNumDigits()) - 1;
+            if (leading >= -5 && leading < int64_t(digits)) {
+                return decimalValue(coefficient, decimalExponent).toString();
+            }
+
+            std::string str = coefficient.toString().substr(isNegative);
+            str.erase(str.find_last_not_of('0') + 1);
+            if (str.size() > 1) str.insert(1, ".");
+            return (isNegative ? "-" : "") + str + "e" + std::to_string(leading);
+        }
+
+        inline size_t hash() const {
+            size_t result = BigInteger(mantissa).hash();
+            result ^= std::hash<int64_t>{}(exponent) + 0x9e3779b97f4a7c15ULL + (result << 6) + (result >> 2);
+            return isNegative ? ~result : result;
+        }
+    };
+} // namespace estd
+
+template <>
+struct std::hash<estd::BigFloat> {
+    inline size_t operator()(const estd::BigFloat& val) const { return val.hash(); }
+};
@@ -1,24 +1,129 @@
 #pragma once
 
-#include <deque>
+#include <cmath>
+#include <estd/BlockBuffer.h>
+#include <estd/DecimalBlocks.h>
+#include <estd/DecimalKernels.h>
+#include <estd/Montgomery.h>
+#include <estd/ThreadPool.h>
 #include <exception>
+#include <functional>
 #include <iomanip>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <numeric>
+#include <random>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 namespace estd {
     class BigDecimal;
+    class BigIntegerArray;
+    class BigDecimalArray;
+    class BigDecimalAccumulator;
+    class ProductTree;
+    class BigRational;
+    template <size_t Scale>
+    class FixedDecimal;
+    template <size_t Bits>
+    class FixedBigInt;
+    class BigBinaryInteger;
+    struct BinaryMirror;
     class BigInteger {
+        friend class BigBinaryInteger;
         friend class BigDecimal;
+        friend class BigIntegerArray;
+        friend class BigDecimalArray;
+        friend class BigDecimalAccumulator;
+        friend class ProductTree;
+        friend class BigRational;
+        template <size_t Scale>
+        friend class FixedDecimal;
+        template <size_t Bits>
+        friend class FixedBigInt;
+
+    public:
+        // runs every task and returns once all of them finished, the tasks may run concurrently
+        typedef std::function<void(const std::vector<std::function<void()>>& tasks)> Executor;
 
     protected:
+        static inline Executor executor;
+        static inline std::unique_ptr<ThreadPool> pool;
+
         bool isNegative = false;
-        std::deque<uint32_t> number; //stored in blocks of 9x base10 digits maxBlock: 999,999,999
+        BlockBuffer number; //stored in blocks of 9x base10 digits maxBlock: 999,999,999
+
+        // reference counted binary form of the value, built by the first bitwise operation and shared by
+        // copies. It remembers the blocks it was built from and is only used while they still match, a const
+        // call only fills an empty cache so concurrent readers never see it replaced (see BigBinaryInteger.h)
+        class MirrorCache {
+        protected:
+            mutable std::atomic<BinaryMirror*> mirror{nullptr};
+
+            inline static BinaryMirror* retain(BinaryMirror* value);
+            inline static void release(BinaryMirror* value);
+
+        public:
+            inline MirrorCache() {}
+            inline MirrorCache(const MirrorCache& other) : mirror(retain(other.get())) {}
+            inline MirrorCache(MirrorCache&& other) noexcept : mirror(other.take()) {}
+            inline ~MirrorCache() { release(take()); }
+
+            inline MirrorCache& operator=(const MirrorCache& other) {
+                BinaryMirror* next = retain(other.get());
+                release(take());
+                mirror.store(next, std::memory_order_release);
+                return *this;
+            }
+            inline MirrorCache& operator=(MirrorCache&& other) noexcept {
+                if (this == &other) return *this;
+                BinaryMirror* next = other.take();
+                release(take());
+                mirror.store(next, std::memory_order_release);
+                return *this;
+            }
+
+            inline BinaryMirror* get() const { return mirror.load(std::memory_order_acquire); }
+            inline BinaryMirror* take() {
+                BinaryMirror* value = mirror.load(std::memory_order_relaxed);
+                mirror.store(nullptr, std::memory_order_relaxed);
+                return value;
+            }
+            inline void reset() { release(take()); }
+
+            // stores value if the cache is empty, false (and value untouched) otherwise
+            inline bool install(BinaryMirror* value) const {
+                BinaryMirror* expected = nullptr;
+                return mirror.compare_exchange_strong(expected, value, std::memory_order_acq_rel);
+            }
+        };
+        MirrorCache binaryMirror;
+
+        // the cached binary form, or the value converted into fallback when it cannot be cached
+        inline const BigBinaryInteger& binaryForm(BigBinaryInteger& fallback) const;
 
-        inline BigInteger(std::deque<uint32_t> d) { number = d; }
+        inline BigInteger(BlockBuffer d) { number = std::move(d); }
 
         inline bool isZero() const { return (number.size() == 1) && (number[0] == 0); }
 
+        // values that fit an int64_t (at most 3 blocks) take the native checked arithmetic paths, anything that
+        // overflows there falls back to the block algorithms
+        inline bool toSmall(int64_t& out) const {
+            size_t n = number.size();
+            if (n == 0 || n > 3) return false;
+            uint64_t magnitude = number[n - 1];
+            if (n >= 2) magnitude += uint64_t(number[n - 2]) * 1000000000;
+            if (n == 3) {
+                if (number[0] > 9) return false;
+                magnitude += uint64_t(number[0]) * 1000000000000000000;
+            }
+            if (magnitude > uint64_t(INT64_MAX)) return false;
+            out = isNegative ? -int64_t(magnitude) : int64_t(magnitude);
+            return true;
+        }
+
         inline void parsePositiveBase10(std::string strNum) {
             if (strNum.size() == 0) throw std::invalid_argument("Cannot parse BigInteger");
 
@@ -117,43 +222,19 @@ namespace estd {
 
         inline BigInteger ninesComplement() const {
             BigInteger result = *this;
-            for (size_t i = 0; i < number.size(); i++) { result.number[i] = 999999999 - result.number[i]; }
+            decimalblocks::kernels().ninesComplement(result.number.begin(), result.number.size());
             return result;
         }
 
         // (sign is ignored)
         inline BigInteger unsignedAdd(const BigInteger& left, const BigInteger& right) const {
-            uint64_t buffer = 0;
-
-            BigInteger result = std::deque<uint32_t>();
-
-            auto iLeft = left.number.rbegin();
-            auto iRight = right.number.rbegin();
-
-            uint64_t vLeft;
-            uint64_t vRight;
-            while (true) {
-                if (iLeft == left.number.rend() && iRight == right.number.rend()) break;
-
-                if (iLeft != left.number.rend()) {
-                    vLeft = *iLeft;
-                    ++iLeft;
-                } else {
-                    vLeft = 0;
-                }
-
-                if (iRight != right.number.rend()) {
-                    vRight = *iRight;
-                    ++iRight;
-                } else {
-                    vRight = 0;
-                }
-
-                buffer += vLeft + vRight;
-                result.number.push_front(buffer % 1000000000);
-                buffer /= 1000000000;
-            }
-            if (buffer != 0) { result.number.push_front(buffer % 1000000000); }
+            size_t n = std::max(left.number.size(), right.number.size());
+            BigInteger result = BlockBuffer(n + 1, 0);
+            decimalblocks::kernels().add(
+                left.number.begin(), left.number.size(), right.number.begin(), right.number.size(),
+                result.number.begin()
+            );
+            if (result.number[0] == 0) result.number.pop_front();
             return result;
         }
 
@@ -167,8 +248,19 @@ namespace estd {
             return unsignedMultiplyKaratsuba(left, right);
         }
 
-        inline BigInteger unsignedMultiplyKaratsuba(const BigInteger left, const BigInteger right) const {
-            if (left.number.size() <= 50 || right.number.size() <= 50) return unsignedMultiplySimple(left, right);
+        // T(args...) to hold results assigned on the executor's threads: those must not draw from this thread's
+        // memory resource, so when parallel the holder is built without one
+        template <class T, class... Args>
+        inline static T parallelResults(bool parallel, Args&&... args) {
+            ScopedBlockResource scope(parallel ? nullptr : BlockBuffer::currentResource());
+            return T(std::forward<Args>(args)...);
+        }
+
+        inline BigInteger unsignedMultiplyKaratsuba(const BigInteger& left, const BigInteger& right) const {
+            // the schoolbook kernels (10^18 limbs or SIMD) beat the split overhead up to about this size
+            if (left.number.size() <= 120 || right.number.size() <= 120) return unsignedMultiplySimple(left, right);
+            if (left.number.size() >= 2 * right.number.size()) return unsignedMultiplyUnbalanced(left, right);
+            if (right.number.size() >= 2 * left.number.size()) return unsignedMultiplyUnbalanced(right, left);
 
             size_t splitSize = left.number.size();
             if (right.number.size() < splitSize) splitSize = right.number.size();
@@ -178,16 +270,31 @@ namespace estd {
 
             // [0] [size-splitSize] [size]
             high1.number =
-                std::deque<uint32_t>(left.number.begin(), left.number.begin() + left.number.size() - splitSize);
+                BlockBuffer(left.number.begin(), left.number.begin() + left.number.size() - splitSize);
             high2.number =
-                std::deque<uint32_t>(right.number.begin(), right.number.begin() + right.number.size() - splitSize);
-            low1.number = std::deque<uint32_t>(left.number.begin() + left.number.size() - splitSize, left.number.end());
+                BlockBuffer(right.number.begin(), right.number.begin() + right.number.size() - splitSize);
+            low1.number = BlockBuffer(left.number.begin() + left.number.size() - splitSize, left.number.end());
             low2.number =
-                std::deque<uint32_t>(right.number.begin() + right.number.size() - splitSize, right.number.end());
-
-            BigInteger z0 = unsignedMultiplyKaratsuba(low1, low2);
-            BigInteger z1 = unsignedMultiplyKaratsuba(unsignedAdd(low1, high1), unsignedAdd(low2, high2));
-            BigInteger z2 = unsignedMultiplyKaratsuba(high1, high2);
+                BlockBuffer(right.number.begin() + right.number.size() - splitSize, right.number.end());
+
+            bool parallel = executor && splitSize * 2 >= parallelThreshold;
+            BigInteger z0 = parallelResults<BigInteger>(parallel), z1 = parallelResults<BigInteger>(parallel);
+            BigInteger z2 = parallelResults<BigInteger>(parallel);
+            auto multiplyLow = [&] { z0 = unsignedMultiplyKaratsuba(low1, low2); };
+            auto multiplyMiddle = [&] {
+                z1 = unsignedMultiplyKaratsuba(unsignedAdd(low1, high1), unsignedAdd(low2, high2));
+            };
+            auto multiplyHigh = [&] { z2 = unsignedMultiplyKaratsuba(high1, high2); };
+
+            // the three products are independent, large ones fan out. every product lands in its own
+            // variable and is combined in the same order, so the result does not depend on the scheduling
+            if (parallel) {
+                executor({multiplyHigh, multiplyMiddle, multiplyLow});
+            } else {
+                multiplyLow();
+                multiplyMiddle();
+                multiplyHigh();
+            }
 
             z1 = z1 - (z2 + z0);
             for (size_t i = 0; i < splitSize; i++) z1.number.push_back(0);
@@ -197,68 +304,756 @@ namespace estd {
             return z2 + z1 + z0;
         }
 
+        // a split of very different operands would keep the long one at full length on every level, so the long
+        // one is cut into pieces as long as the short one. the balanced products are independent and fan out
+        // like karatsuba's, then they are added at their offsets.
+        inline BigInteger unsignedMultiplyUnbalanced(const BigInteger& longer, const BigInteger& shorter) const {
+            size_t piece = shorter.number.size();
+            size_t pieces = (longer.number.size() + piece - 1) / piece;
+
+            bool parallel = executor && piece * 2 >= parallelThreshold;
+            auto products = parallelResults<std::vector<BigInteger>>(parallel, pieces);
+            std::vector<std::function<void()>> tasks;
+            for (size_t i = 0; i < pieces; i++) {
+                tasks.push_back([&, i] {
+                    // piece i holds the blocks i * piece .. (i + 1) * piece counted from the least significant
+                    size_t end = longer.number.size() - i * piece;
+                    size_t begin = end > piece ? end - piece : 0;
+                    BigInteger part = BlockBuffer(longer.number.begin() + begin, longer.number.begin() + end);
+                    products[i] = unsignedMultiplyKaratsuba(part.trimLeadingZeros(), shorter);
+                });
+            }
+            if (parallel) {
+                executor(tasks);
+            } else {
+                for (auto& task : tasks) task();
+            }
+
+            // little endian sum
+            std::vector<uint32_t> sum(longer.number.size() + piece + 1, 0);
+            for (size_t i = 0; i < pieces; i++) {
+                const BlockBuffer& product = products[i].number;
+                uint64_t carry = 0;
+                size_t k = i * piece;
+                for (size_t j = product.size(); j-- > 0; k++) {
+                    carry += uint64_t(sum[k]) + product[j];
+                    sum[k] = carry % 1000000000;
+                    carry /= 1000000000;
+                }
+                for (; carry != 0; k++) {
+                    carry += sum[k];
+                    sum[k] = carry % 1000000000;
+                    carry /= 1000000000;
+                }
+            }
+            BigInteger result = BlockBuffer(sum.rbegin(), sum.rend());
+            return result.trimLeadingZeros();
+        }
+
         // base case for karatsuba
         inline BigInteger unsignedMultiplySimple(const BigInteger& left, const BigInteger& right) const {
-            if (right == 0 || left == 0) return 0;
+            if (right.isZero() || left.isZero()) return 0;
+            BigInteger result = BlockBuffer(left.number.size() + right.number.size(), 0);
+            decimalblocks::kernels().multiply(
+                left.number.begin(), left.number.size(), right.number.begin(), right.number.size(),
+                result.number.begin()
+            );
+            return result.trimLeadingZeros();
+        }
+
+        // multiply by a single block (0 <= right < 1000000000)
+        inline BigInteger unsignedMultiplySmall(const BigInteger& left, uint32_t right) const {
+            if (right == 0 || left.isZero()) return 0;
+            BigInteger result = nullptr;
             uint64_t buffer = 0;
+            for (auto iLeft = left.number.rbegin(); iLeft != left.number.rend(); ++iLeft) {
+                buffer += uint64_t(*iLeft) * right;
+                result.number.push_front(buffer % 1000000000);
+                buffer /= 1000000000;
+            }
+            if (buffer != 0) result.number.push_front(buffer);
+            return result;
+        }
 
+        // divide by a single block (0 < right < 1000000000), returns {quotient, remainder}
+        inline std::pair<BigInteger, uint32_t> unsignedDivideSmall(const BigInteger& left, uint32_t right) const {
+            if (right == 0) throw std::invalid_argument("Cannot divide by zero");
             BigInteger result = nullptr;
+            uint64_t remainder = 0;
+            for (auto token : left.number) {
+                remainder = remainder * 1000000000 + token;
+                result.number.push_back(remainder / right);
+                remainder %= right;
+            }
+            result.trimLeadingZeros();
+            return {result, uint32_t(remainder)};
+        }
+
+        // left * base^exponent for a small base (1 < base < 1000000000), one block multiply per chunk of the power
+        inline BigInteger unsignedMultiplyPower(const BigInteger& left, uint32_t base, size_t exponent) const {
+            BigInteger result = left;
+            result.isNegative = false;
+            uint32_t chunk = 1;
+            size_t chunkExponent = 0;
+            while (uint64_t(chunk) * base < 1000000000) {
+                chunk *= base;
+                chunkExponent++;
+            }
+            for (; exponent >= chunkExponent; exponent -= chunkExponent) result = unsignedMultiplySmall(result, chunk);
+            for (; exponent > 0; exponent--) result = unsignedMultiplySmall(result, base);
+            return result;
+        }
+
+        // floor(left / base^exponent) for a small base (1 < base < 1000000000), the flag is set when the
+        // division was exact. powers of ten drop whole blocks first.
+        inline std::pair<BigInteger, bool>
+        unsignedDividePower(const BigInteger& left, uint32_t base, size_t exponent) const {
+            BigInteger result = left;
+            result.isNegative = false;
+            bool exact = true;
+            if (base == 10) {
+                for (; exponent >= 9 && result.number.size() > 1; exponent -= 9) {
+                    exact = exact && result.number[result.number.size() - 1] == 0;
+                    result.number.pop_back();
+                }
+                if (exponent >= 9) return {0, exact && result.isZero()};
+            }
+            uint32_t chunk = 1;
+            size_t chunkExponent = 0;
+            while (uint64_t(chunk) * base < 1000000000) {
+                chunk *= base;
+                chunkExponent++;
+            }
+            while (exponent > 0 && !result.isZero()) {
+                uint32_t divisor = chunk;
+                if (exponent >= chunkExponent) {
+                    exponent -= chunkExponent;
+                } else {
+                    divisor = 1;
+                    for (; exponent > 0; exponent--) divisor *= base;
+                }
+                auto qr = unsignedDivideSmall(result, divisor);
+                exact = exact && qr.second == 0;
+                result = qr.first;
+            }
+            return {result, exact};
+        }
+
+        // the value without its lowest count blocks (sign is ignored)
+        inline BigInteger dropBlocks(const BigInteger& value, size_t count) const {
+            if (count >= value.number.size()) return 0;
+            return BlockBuffer(value.number.begin(), value.number.end() - count);
+        }
+
+        // floor(base^(2n) / v), off by a few units at most, for a divisor of n blocks. Newton's iteration
+        // x + x * (base^(2n) - v * x) / base^(2n) doubles the precision of the reciprocal of the leading
+        // blocks, every step only multiplies the blocks that still carry precision.
+        inline BigInteger unsignedReciprocal(const BigInteger& v) const {
+            size_t n = v.number.size();
+            if (n <= newtonDivideThreshold) {
+                BigInteger scale = BlockBuffer(2 * n + 1, 0);
+                scale.number[0] = 1;
+                return unsignedDivide(scale, v).first;
+            }
+
+            // with x = head * base^(n - h) the step is head + head * (base^(n + h) - v * head) / base^(2h)
+            size_t h = n / 2 + 2;
+            BigInteger head = unsignedReciprocal(BlockBuffer(v.number.begin(), v.number.begin() + h));
+            BigInteger scale = BlockBuffer(n + h + 1, 0);
+            scale.number[0] = 1;
+            BigInteger product = unsignedMultiply(v, head);
+            bool low = isMagnitudeLessThan(product, scale);
+            BigInteger error = low ? unsignedSubtract(scale, product) : unsignedSubtract(product, scale);
+            // the lowest h - 2 blocks of the error move the result by less than a unit
+            BigInteger correction = dropBlocks(unsignedMultiply(head, dropBlocks(error, h - 2)), h + 2);
+            head.number.insert(head.number.end(), n - h, 0);
+            return low ? unsignedAdd(head, correction) : unsignedSubtract(head, correction);
+        }
+
+        // division by multiplying with the reciprocal of the divisor, the estimate is off by a few units and
+        // corrected against the remainder (sign is ignored)
+        inline std::pair<BigInteger, BigInteger>
+        unsignedDivideNewton(const BigInteger& left, const BigInteger& right) const {
+            size_t quotientBlocks = left.number.size() - right.number.size() + 1;
+            // only the leading blocks of the divisor matter for a short quotient
+            size_t dropped = right.number.size() > quotientBlocks + 2 ? right.number.size() - quotientBlocks - 2 : 0;
+            BigInteger divisor = dropBlocks(right, dropped);
+            size_t n = divisor.number.size();
+            size_t precision = std::max(n, quotientBlocks);
+            divisor.number.insert(divisor.number.end(), precision - n, 0);
+
+            // reciprocal ~ base^(precision + n) / divisor, the lowest n - 2 blocks of the dividend move the
+            // quotient by less than a unit
+            size_t ignored = dropped + n - 2;
+            BigInteger quotient = unsignedMultiply(dropBlocks(left, ignored), unsignedReciprocal(divisor));
+            quotient = dropBlocks(quotient, precision + 2);
+
+            BigInteger product = unsignedMultiply(quotient, right);
+            while (isMagnitudeLessThan(left, product)) {
+                quotient = unsignedSubtractSmall(quotient, 1);
+                product = unsignedSubtract(product, right);
+            }
+            BigInteger remainder = unsignedSubtract(left, product);
+            while (!isMagnitudeLessThan(remainder, right)) {
+                quotient = unsignedAddSmall(quotient, 1);
+                remainder = unsignedSubtract(remainder, right);
+            }
+            return {quotient, remainder};
+        }
+
+        // schoolbook long division (Knuth's algorithm D) in base 1000000000, large divisions with a long
+        // quotient go through the reciprocal (sign is ignored)
+        inline std::pair<BigInteger, BigInteger> unsignedDivide(const BigInteger& left, const BigInteger& right) const {
+            const uint64_t base = 1000000000;
+
+            if (right.isZero()) throw std::invalid_argument("Cannot divide by zero");
+            if (isMagnitudeLessThan(left, right)) {
+                BigInteger remainder = left;
+                remainder.isNegative = false;
+                return {0, remainder};
+            }
+            if (right.number.size() == 1) {
+                auto result = unsignedDivideSmall(left, right.number[0]);
+                return {result.first, BigInteger(result.second)};
+            }
+            if (right.number.size() > newtonDivideThreshold &&
+                left.number.size() - right.number.size() >= newtonDivideThreshold) {
+                return unsignedDivideNewton(left, right);
+            }
+
+            // normalize so the leading block of the divisor is at least base / 2, this keeps the
+            // quotient estimate from the two leading blocks off by at most 2
+            uint32_t scale = base / (uint64_t(right.number[0]) + 1);
+            BigInteger uScaled = unsignedMultiplySmall(left, scale);
+            BigInteger vScaled = unsignedMultiplySmall(right, scale);
+
+            // little endian working copies, u gets an extra leading block
+            std::vector<uint32_t> u(uScaled.number.rbegin(), uScaled.number.rend());
+            std::vector<uint32_t> v(vScaled.number.rbegin(), vScaled.number.rend());
+            if (u.size() == left.number.size()) u.push_back(0);
+
+            size_t n = v.size();
+            size_t m = u.size() - n - 1;
+            std::vector<uint32_t> q(m + 1, 0);
+
+            for (size_t j = m + 1; j-- > 0;) {
+                uint64_t numerator = uint64_t(u[j + n]) * base + u[j + n - 1];
+                uint64_t qhat = numerator / v[n - 1];
+                uint64_t rhat = numerator % v[n - 1];
+                while (qhat >= base || qhat * v[n - 2] > rhat * base + u[j + n - 2]) {
+                    qhat--;
+                    rhat += v[n - 1];
+                    if (rhat >= base) break;
+                }
+
+                // u[j .. j+n] -= qhat * v
+                uint64_t carry = 0;
+                int64_t borrow = 0;
+                for (size_t i = 0; i < n; i++) {
+                    uint64_t product = qhat * v[i] + carry;
+                    carry = product / base;
+                    int64_t diff = int64_t(u[i + j]) - int64_t(product % base) - borrow;
+                    borrow = diff < 0;
+                    u[i + j] = uint32_t(diff + borrow * int64_t(base));
+                }
+                int64_t diff = int64_t(u[j + n]) - int64_t(carry) - borrow;
+                borrow = diff < 0;
+                u[j + n] = uint32_t(diff + borrow * int64_t(base));
+
+                if (borrow) { // estimate was one too large, add the divisor back
+                    qhat--;
+                    uint64_t sum = 0;
+                    for (size_t i = 0; i < n; i++) {
+                        sum += uint64_t(u[i + j]) + v[i];
+                        u[i + j] = sum % base;
+                        sum /= base;
+                    }
+                    u[j + n] = (u[j + n] + sum) % base;
+                }
+                q[j] = qhat;
+            }
+
+            BigInteger quotient = BlockBuffer(q.rbegin(), q.rend());
+            BigInteger remainder = BlockBuffer(u.rbegin() + (u.size() - n), u.rend());
+            quotient.trimLeadingZeros();
+            remainder.trimLeadingZeros();
+            return {quotient, unsignedDivideSmall(remainder, scale).first};
+        }
+
+        // floor(sqrt(n)) by newton iteration (sign is ignored). the start is one above the root of the leading
+        // half of the blocks, close enough that a single full size step lands on the floor or one above it, so
+        // the precision doubles per level and the whole costs a few multiplications. short values iterate from
+        // the root of their leading blocks.
+        inline BigInteger unsignedSqrt(const BigInteger& n) const {
+            if (n.number.size() <= 2) {
+                uint64_t value = n.number[n.number.size() - 1];
+                if (n.number.size() == 2) value += uint64_t(n.number[0]) * 1000000000;
+                uint64_t root = uint64_t(std::sqrt((long double)value));
+                while (root * root > value) root--;
+                while ((root + 1) * (root + 1) <= value) root++;
+                return root;
+            }
+
+            // the root has at least (size - 1) / 2 blocks, the start is off by less than base^t
+            size_t rootBlocks = (n.number.size() - 1) / 2;
+            if (rootBlocks < 3) {
+                BigInteger top = BlockBuffer(n.number.begin(), n.number.end() - 2 * rootBlocks);
+                BigInteger x = unsignedAdd(unsignedSqrt(top), 1); // x >= sqrt(n), newton decreases to the floor
+                x.number.insert(x.number.end(), rootBlocks, 0);
+                while (true) {
+                    BigInteger y = unsignedDivideSmall(unsignedAdd(x, unsignedDivide(n, x).first), 2).first;
+                    if (!isMagnitudeLessThan(y, x)) return x;
+                    x = y;
+                }
+            }
+
+            size_t t = (rootBlocks - 1) / 2;
+            BigInteger x = unsignedAddSmall(unsignedSqrt(dropBlocks(n, 2 * t)), 1);
+            x.number.insert(x.number.end(), t, 0);
+            BigInteger y = unsignedDivideSmall(unsignedAdd(x, unsignedDivide(n, x).first), 2).first;
+            if (isMagnitudeLessThan(n, unsignedMultiply(y, y))) y = unsignedSubtractSmall(y, 1);
+            return y;
+        }
+
+        // log10 of the magnitude from its three leading blocks, exact to about 19 digits
+        inline static long double logarithm10(const BigInteger& n) {
+            long double lead = 0;
+            for (size_t i = 0; i < 3; i++) lead = lead * 1e9L + (i < n.number.size() ? n.number[i] : 0);
+            return std::log10(lead) + 9.0L * (int64_t(n.number.size()) - 3);
+        }
 
-            uint64_t vLeft;
-            uint64_t vRight;
-
-            int prepush = 0;
-            for (auto iRight = right.number.rbegin(); iRight != right.number.rend(); ++iRight) {
-                BigInteger tmp = nullptr;
-                for (int i = 0; i < prepush; i++) tmp.number.push_front(0);
-                prepush++;
-                for (auto iLeft = left.number.rbegin(); iLeft != left.number.rend(); ++iLeft) {
-                    vLeft = *iLeft;
-                    vRight = *iRight;
-
-                    buffer += vLeft * vRight;
-                    tmp.number.push_front(buffer % 1000000000);
-                    buffer /= 1000000000;
+        // floor(n^(1/k)) for k >= 2 (sign is ignored), newton's iteration x - (x - n / x^(k-1)) / k like
+        // unsignedSqrt: one step from the root of the leading blocks, short roots iterate from a floating
+        // point estimate or the root of the leading blocks
+        inline BigInteger unsignedRoot(const BigInteger& n, size_t k) const {
+            if (k == 2) return unsignedSqrt(n);
+            if (n.isZero()) return 0;
+            // 2^k > 10^digits > n
+            if (k > n.getNumDigits() * 3.33) return 1;
+
+            auto step = [&](const BigInteger& x) {
+                return (x * (k - 1) + unsignedDivide(n, x.power(k - 1)).first) / k;
+            };
+            size_t rootBlocks = (n.number.size() - 1) / k;
+            if (rootBlocks >= 3) {
+                size_t t = (rootBlocks - 1) / 2;
+                BigInteger x = unsignedAddSmall(unsignedRoot(dropBlocks(n, k * t), k), 1);
+                x.number.insert(x.number.end(), t, 0);
+                BigInteger y = step(x);
+                if (isMagnitudeLessThan(n, y.power(k))) y = unsignedSubtractSmall(y, 1);
+                return y;
+            }
+
+            BigInteger x;
+            size_t t = n.number.size() / (2 * k);
+            if (t == 0) {
+                long double estimate = std::pow(10.0L, logarithm10(n) / k);
+                x = uint64_t(estimate * (1 + 1e-12L)) + 2; // the root is below 10^18, so is the estimate
+            } else {
+                x = unsignedAddSmall(unsignedRoot(dropBlocks(n, k * t), k), 1);
+                x.number.insert(x.number.end(), t, 0);
+            }
+            while (true) {
+                BigInteger y = step(x);
+                if (!isMagnitudeLessThan(y, x)) return x;
+                x = y;
+            }
+        }
+
+        // n mod m for m < 2^32 (sign is ignored)
+        inline static uint64_t unsignedModulo(const BigInteger& n, uint64_t m) {
+            uint64_t remainder = 0;
+            for (auto block : n.number) remainder = (remainder * 1000000000 + block) % m;
+            return remainder;
+        }
+
+        // n mod every modulus (each below 2^32) in one pass over the blocks, the divisions are independent
+        inline static std::vector<uint64_t> unsignedModuli(const BigInteger& n, const std::vector<uint64_t>& moduli) {
+            std::vector<uint64_t> remainders(moduli.size(), 0);
+            for (auto block : n.number) {
+                for (size_t i = 0; i < moduli.size(); i++) {
+                    remainders[i] = (remainders[i] * 1000000000 + block) % moduli[i];
+                }
+            }
+            return remainders;
+        }
+
+        // base^exponent mod m for m < 2^32
+        inline static uint64_t powerModulo(uint64_t base, uint64_t exponent, uint64_t m) {
+            uint64_t result = 1 % m;
+            for (base %= m; exponent != 0; exponent >>= 1) {
+                if (exponent & 1) result = result * base % m;
+                base = base * base % m;
+            }
+            return result;
+        }
+
+        inline static bool isSquareResidue(uint64_t x, uint64_t m) {
+            for (uint64_t i = 0; i <= m / 2; i++) {
+                if (i * i % m == x) return true;
+            }
+            return false;
+        }
+
+        inline static bool isSmallPrime(uint64_t n) {
+            if (n < 2) return false;
+            for (uint64_t d = 2; d * d <= n; d++) {
+                if (n % d == 0) return false;
+            }
+            return true;
+        }
+
+        // the smallest prime q = 1 (mod p) above after, 1 (a modulus that tests nothing) past 2^32
+        inline static uint64_t residueModulus(size_t p, uint64_t after) {
+            uint64_t q = after < 2 * p + 1 ? 2 * p + 1 : after + 2 * p - (after - 1) % (2 * p);
+            for (; q < (uint64_t(1) << 32); q += 2 * p) {
+                if (isSmallPrime(q)) return q;
+            }
+            return 1;
+        }
+
+        // a p-th power is a p-th power residue modulo every prime q = 1 (mod p), a random value only with
+        // probability 1 / p
+        inline static bool isPowerResidue(uint64_t x, size_t p, uint64_t q) {
+            return q == 1 || x == 0 || powerModulo(x, (q - 1) / p, q) == 1;
+        }
+
+        // false when n (sign is ignored) is certainly no p-th power, tests two more moduli above after
+        inline static bool mayBePower(const BigInteger& n, size_t p, uint64_t after) {
+            for (size_t i = 0; i < 2 && after != 1; i++) {
+                after = residueModulus(p, after);
+                if (!isPowerResidue(unsignedModulo(n, after), p, after)) return false;
+            }
+            return true;
+        }
+
+        // squares are quadratic residues modulo 64 (the last block decides it) and modulo 63 * 65 * 11
+        inline bool isUnsignedSquare(const BigInteger& n) const {
+            if (!isSquareResidue(n.number[n.number.size() - 1] % 64, 64)) return false;
+            uint64_t residue = unsignedModulo(n, 63 * 65 * 11);
+            if (!isSquareResidue(residue % 63, 63) || !isSquareResidue(residue % 65, 65) ||
+                !isSquareResidue(residue % 11, 11)) {
+                return false;
+            }
+            BigInteger root = unsignedSqrt(n);
+            return isMagnitudeEqual(unsignedMultiply(root, root), n);
+        }
+
+        // the primes up to n, sieve of eratosthenes over the odd numbers
+        inline static std::vector<uint64_t> primesUpTo(uint64_t n) {
+            std::vector<uint64_t> primes;
+            if (n < 2) return primes;
+            primes.push_back(2);
+            std::vector<bool> composite((n - 1) / 2, false); // index i stands for 2i + 3
+            for (uint64_t i = 0; i < composite.size(); i++) {
+                if (composite[i]) continue;
+                uint64_t p = 2 * i + 3;
+                primes.push_back(p);
+                if (p > n / p) continue;
+                for (uint64_t multiple = p * p; multiple <= n; multiple += 2 * p) composite[(multiple - 3) / 2] = true;
+            }
+            return primes;
+        }
+
+        // the exponent of the prime p in n! (legendre's formula)
+        inline static uint64_t factorialExponent(uint64_t n, uint64_t p) {
+            uint64_t exponent = 0;
+            for (n /= p; n != 0; n /= p) exponent += n;
+            return exponent;
+        }
+
+        // native factors multiplied together while they fit, so a tree leaf is a single value (factors > 0)
+        inline static std::vector<BigInteger> packFactors(const std::vector<uint64_t>& factors) {
+            std::vector<BigInteger> packed;
+            uint64_t current = 1;
+            for (uint64_t factor : factors) {
+                if (factor > UINT64_MAX / current) {
+                    packed.push_back(current);
+                    current = 1;
                 }
-                while (buffer != 0) {
-                    tmp.number.push_front(buffer % 1000000000);
-                    buffer /= 1000000000;
+                current *= factor;
+            }
+            packed.push_back(current);
+            return packed;
+        }
+
+        // product of values[0, n) as a balanced tree, so the large multiplications are between operands of
+        // similar size. the halves of a large subtree run in parallel on the executor.
+        inline static BigInteger productTree(const BigInteger* values, size_t n) {
+            if (n == 0) return 1;
+            if (n == 1) return values[0];
+            size_t blocks = 0;
+            for (size_t i = 0; i < n; i++) blocks += values[i].number.size();
+
+            bool parallel = executor && blocks >= parallelThreshold;
+            BigInteger left = parallelResults<BigInteger>(parallel), right = parallelResults<BigInteger>(parallel);
+            auto multiplyLeft = [&] { left = productTree(values, n / 2); };
+            auto multiplyRight = [&] { right = productTree(values + n / 2, n - n / 2); };
+            if (parallel) {
+                executor({multiplyLeft, multiplyRight});
+            } else {
+                multiplyLeft();
+                multiplyRight();
+            }
+            return left * right;
+        }
+
+        // product of primes[i]^exponents[i]. the primes are grouped by the bits of their exponents, every group
+        // is one product tree and the groups are combined by repeated squaring from the highest bit
+        inline static BigInteger
+        primePowerProduct(const std::vector<uint64_t>& primes, const std::vector<uint64_t>& exponents) {
+            uint64_t bits = 0;
+            for (auto exponent : exponents) bits |= exponent;
+            BigInteger result = 1;
+            for (int bit = 63; bit >= 0; bit--) {
+                if ((bits >> bit) == 0) continue;
+                if (!(result == 1)) result *= result;
+                std::vector<uint64_t> group;
+                for (size_t i = 0; i < primes.size(); i++) {
+                    if ((exponents[i] >> bit) & 1) group.push_back(primes[i]);
                 }
-                result += tmp;
+                std::vector<BigInteger> packed = packFactors(group);
+                result *= productTree(packed.data(), packed.size());
             }
-            if (result.number.size() == 0) result.number.push_front(0);
             return result;
         }
 
-        // binary search divide
-        inline std::pair<BigInteger, BigInteger> unsignedDivide(BigInteger left, BigInteger right) const {
-            std::pair<BigInteger, BigInteger> result = {0, 0};
+        // numbers below the square of this are prime when trial division finds no factor
+        static constexpr uint64_t trialDivisionBound = 2000;
 
-            left.isNegative = false;
-            right.isNegative = false;
+        // the odd primes below trialDivisionBound and their products packed below 2^32, so one pass of single
+        // block divisions (unsignedModuli) reduces a number modulo all of them
+        struct TrialDivisors {
+            std::vector<uint64_t> primes;
+            std::vector<uint64_t> products;
+            std::vector<size_t> groups; // the product each prime is part of
+        };
 
+        inline static const TrialDivisors& trialDivisors() {
+            static const TrialDivisors divisors = [] {
+                TrialDivisors result;
+                std::vector<uint64_t> primes = primesUpTo(trialDivisionBound);
+                result.primes.assign(primes.begin() + 1, primes.end());
+                for (uint64_t p : result.primes) {
+                    if (result.products.empty() || result.products.back() > (uint64_t(1) << 32) / p) {
+                        result.products.push_back(1);
+                    }
+                    result.products.back() *= p;
+                    result.groups.push_back(result.products.size() - 1);
+                }
+                return result;
+            }();
+            return divisors;
+        }
 
-            if (right == 0) throw std::invalid_argument("Cannot divide by zero");
-            if (isMagnitudeLessThan(left, right)) return {0, left};
-            if (left == 0) return {0, 0};
+        // n mod every trial prime (sign is ignored)
+        inline static std::vector<uint64_t> trialResidues(const BigInteger& n) {
+            const TrialDivisors& divisors = trialDivisors();
+            std::vector<uint64_t> packed = unsignedModuli(n, divisors.products);
+            std::vector<uint64_t> residues(divisors.primes.size());
+            for (size_t i = 0; i < residues.size(); i++) residues[i] = packed[divisors.groups[i]] % divisors.primes[i];
+            return residues;
+        }
+
+        // the jacobi symbol (a / n) for odd n
+        inline static int jacobi(uint64_t a, uint64_t n) {
+            int result = 1;
+            for (a %= n; a != 0; a %= n) {
+                for (; a % 2 == 0; a /= 2) {
+                    if (n % 8 == 3 || n % 8 == 5) result = -result;
+                }
+                std::swap(a, n);
+                if (a % 4 == 3 && n % 4 == 3) result = -result;
+            }
+            return n == 1 ? result : 0;
+        }
+
+        // (a / n) for a != 0 and odd n (sign is ignored), reciprocity turns it into (n mod |a| / |a|). n mod 8
+        // is the last block's since 8 divides the base.
+        inline static int jacobi(int64_t a, const BigInteger& n) {
+            uint64_t low = n.number[n.number.size() - 1] % 8;
+            int result = a < 0 && low % 4 == 3 ? -1 : 1;
+            uint64_t x = a < 0 ? uint64_t(-a) : uint64_t(a);
+            for (; x % 2 == 0; x /= 2) {
+                if (low == 3 || low == 5) result = -result;
+            }
+            if (x % 4 == 3 && low % 4 == 3) result = -result;
+            return x == 1 ? result : result * jacobi(unsignedModulo(n, x), x);
+        }
+
+        typedef decimalblocks::Montgomery Montgomery;
+        typedef Montgomery::Residue Residue;
+
+        // x * R mod n (sign is ignored), n is the field's modulus
+        inline Residue toMontgomery(const Montgomery& field, const BigInteger& x, const BigInteger& n) const {
+            BigInteger shifted = x;
+            shifted.number.insert(shifted.number.end(), field.size(), 0);
+            BigInteger reduced = unsignedDivide(shifted, n).second;
+            Residue result(field.size(), 0);
+            for (size_t i = 0; i < reduced.number.size(); i++) {
+                result[i] = reduced.number[reduced.number.size() - 1 - i];
+            }
+            return result;
+        }
 
-            BigInteger leftBound = 0;
-            BigInteger rightBound = left;
+        inline static BigInteger fromMontgomery(const Montgomery& field, const Residue& x) {
+            Residue one(field.size(), 0), value;
+            one[0] = 1;
+            field.multiply(x, one, value);
+            BigInteger result = BlockBuffer(value.rbegin(), value.rend());
+            return result.trimLeadingZeros();
+        }
 
-            BigInteger& target = left;
-            while (leftBound <= rightBound) {
-                BigInteger guess = (leftBound + rightBound) >> 1;
-                BigInteger val = guess * right;
+        // base^exponent (exponent >= 0) in montgomery form, left to right over windows of 4 bits
+        inline static Residue
+        montgomeryPower(const Montgomery& field, const Residue& base, const BigInteger& exponent, const Residue& one) {
+            std::vector<Residue> powers(16, one);
+            for (size_t i = 1; i < 16; i++) field.multiply(powers[i - 1], base, powers[i]);
+            Residue result = one;
+            for (size_t window = (exponent.bitLength() + 3) / 4; window-- > 0;) {
+                for (int i = 0; i < 4 && result != one; i++) field.multiply(result, result, result);
+                size_t digit = 0;
+                for (size_t bit = 4; bit-- > 0;) digit = digit * 2 + exponent.testBit(4 * window + bit);
+                if (digit != 0) field.multiply(result, powers[digit], result);
+            }
+            return result;
+        }
+
+        // miller-rabin round for odd n = d * 2^s + 1 to the base a (montgomery form)
+        inline static bool isStrongProbablePrime(
+            const Montgomery& field, const Residue& a, const BigInteger& d, size_t s, const Residue& one,
+            const Residue& minusOne
+        ) {
+            Residue x = montgomeryPower(field, a, d, one);
+            if (x == one || x == minusOne) return true;
+            for (size_t r = 1; r < s; r++) {
+                field.multiply(x, x, x);
+                if (x == minusOne) return true;
+                if (x == one) return false;
+            }
+            return false;
+        }
 
-                if (val <= target && (val + right) > target) { return {guess, target - val}; }
-                if (target < val) {
-                    rightBound = guess - 1;
+        // strong lucas test with selfridge's parameters: the first D of 5, -7, 9, -11, ... with (D / n) = -1,
+        // P = 1 and Q = (1 - D) / 4. With n + 1 = d * 2^s, n passes when U_d = 0 or V_(d * 2^r) = 0 for an
+        // r < s. Only V runs (a ladder over V_k, V_(k + 1) and Q^k), U_d = 0 is 2 V_(d + 1) = V_d since
+        // D U_k = 2 V_(k + 1) - P V_k and D is invertible.
+        inline bool isStrongLucasProbablePrime(const Montgomery& field, const BigInteger& n, const Residue& one) const {
+            // squares never have a D with (D / n) = -1
+            if (isUnsignedSquare(n)) return false;
+            int64_t d = 5;
+            for (int symbol = jacobi(d, n); symbol != -1; symbol = jacobi(d, n)) {
+                if (symbol == 0) return false; // n is larger than |D| and shares a factor with it
+                d = d > 0 ? -(d + 2) : 2 - d;
+            }
+            int64_t q = (1 - d) / 4;
+            Residue zero(field.size(), 0), qResidue = toMontgomery(field, q < 0 ? -q : q, n);
+            if (q < 0) field.subtract(zero, qResidue, qResidue);
+
+            BigInteger exponent = unsignedAddSmall(n, 1);
+            size_t s = 0;
+            for (; exponent.number[exponent.number.size() - 1] % 2 == 0; s++) {
+                exponent = unsignedDivideSmall(exponent, 2).first;
+            }
+
+            Residue v, next = one, power = one, odd;
+            field.add(one, one, v);
+            for (size_t bit = exponent.bitLength(); bit-- > 0;) {
+                // V_(2k + 1) = V_k V_(k + 1) - Q^k and V_2k = V_k^2 - 2 Q^k (P = 1)
+                field.multiply(v, next, odd);
+                field.subtract(odd, power, odd);
+                if (exponent.testBit(bit)) {
+                    Residue powerNext;
+                    field.multiply(power, qResidue, powerNext);
+                    field.multiply(next, next, next);
+                    field.subtract(next, powerNext, next);
+                    field.subtract(next, powerNext, next);
+                    v = odd;
+                    field.multiply(power, powerNext, power);
                 } else {
-                    leftBound = guess + 1;
+                    field.multiply(v, v, v);
+                    field.subtract(v, power, v);
+                    field.subtract(v, power, v);
+                    next = odd;
+                    field.multiply(power, power, power);
                 }
             }
 
-            return result;
+            field.add(next, next, odd);
+            if (odd == v) return true;
+            for (size_t r = 0; r < s; r++) {
+                if (Montgomery::isZero(v)) return true;
+                field.multiply(v, v, v);
+                field.subtract(v, power, v);
+                field.subtract(v, power, v);
+                field.multiply(power, power, power);
+            }
+            return false;
+        }
+
+        // baillie-psw for odd n above trialDivisionBound^2 without a trial factor: a miller-rabin round to the
+        // base 2 and a strong lucas test (no composite passing both is known), then rounds more miller-rabin
+        // rounds to the bases nextBase returns (in [2, n - 2])
+        inline bool isBailliePSWPrime(
+            const BigInteger& n, size_t rounds = 0, const std::function<BigInteger()>& nextBase = nullptr
+        ) const {
+            Montgomery field(n.number.begin(), n.number.size());
+            Residue one = toMontgomery(field, 1, n), minusOne;
+            field.subtract(Residue(field.size(), 0), one, minusOne);
+            BigInteger d = unsignedSubtractSmall(n, 1);
+            size_t s = 0;
+            for (; d.number[d.number.size() - 1] % 2 == 0; s++) d = unsignedDivideSmall(d, 2).first;
+
+            if (!isStrongProbablePrime(field, toMontgomery(field, 2, n), d, s, one, minusOne)) return false;
+            if (!isStrongLucasProbablePrime(field, n, one)) return false;
+            for (size_t round = 0; round < rounds; round++) {
+                Residue base = toMontgomery(field, nextBase(), n);
+                if (!isStrongProbablePrime(field, base, d, s, one, minusOne)) return false;
+            }
+            return true;
+        }
+
+        // trial division by the primes below trialDivisionBound, then isBailliePSWPrime
+        inline bool isProbablePrimeWith(size_t rounds, const std::function<BigInteger()>& nextBase) const {
+            if (number.size() == 0 || isNegative) return false;
+            int64_t small;
+            bool isSmall = toSmall(small);
+            if (isSmall && uint64_t(small) <= trialDivisionBound) return isSmallPrime(small);
+            if (number[number.size() - 1] % 2 == 0) return false;
+            for (uint64_t residue : trialResidues(*this)) {
+                if (residue == 0) return false;
+            }
+            if (isSmall && uint64_t(small) < trialDivisionBound * trialDivisionBound) return true;
+            return isBailliePSWPrime(*this, rounds, nextBase);
+        }
+
+        // uniform in [0, 10^18), two blocks per draw. The output of a full 64 bit generator is used directly and
+        // drawn again at or above the largest multiple of 10^18 below 2^64 (a 2.4% chance), any other generator
+        // goes through uniform_int_distribution.
+        template <class Generator>
+        inline static uint64_t randomBlockPair(Generator& rng) {
+            constexpr uint64_t range = uint64_t(decimalblocks::base) * decimalblocks::base;
+            if constexpr (Generator::min() == 0 && Generator::max() == UINT64_MAX) {
+                constexpr uint64_t limit = UINT64_MAX / range * range;
+                while (true) {
+                    uint64_t x = rng();
+                    if (x < limit) return x % range;
+                }
+            } else {
+                return std::uniform_int_distribution<uint64_t>(0, range - 1)(rng);
+            }
+        }
+
+        // uniform blocks from index from on
+        template <class Generator>
+        inline static void fillRandom(BlockBuffer& blocks, size_t from, Generator& rng) {
+            size_t i = from;
+            for (; i + 2 <= blocks.size(); i += 2) {
+                uint64_t pair = randomBlockPair(rng);
+                blocks[i] = uint32_t(pair / decimalblocks::base);
+                blocks[i + 1] = uint32_t(pair % decimalblocks::base);
+            }
+            if (i < blocks.size()) blocks[i] = uint32_t(randomBlockPair(rng) % decimalblocks::base);
         }
 
         //not used as it appears to be a bit slower than the recursive case, does use less memory though
@@ -291,18 +1086,163 @@ namespace estd {
         }
 
         inline bool isMagnitudeLessThan(const BigInteger& left, const BigInteger& right) const {
-            if (left.number.size() < right.number.size()) return true;
-            if (left.number.size() > right.number.size()) return false;
+            return decimalblocks::kernels().compare(
+                       left.number.begin(), left.number.size(), right.number.begin(), right.number.size()
+                   ) < 0;
+        }
 
-            for (size_t i = 0; i < left.number.size(); i++) {
-                if (left.number[i] < right.number[i]) return true;
-                if (left.number[i] > right.number[i]) return false;
+        inline bool isMagnitudeEqual(const BigInteger& left, const BigInteger& right) const {
+            return decimalblocks::kernels().compare(
+                       left.number.begin(), left.number.size(), right.number.begin(), right.number.size()
+                   ) == 0;
+        }
+
+        // |left| + right (sign is ignored)
+        inline BigInteger unsignedAddSmall(const BigInteger& left, uint64_t right) const {
+            BigInteger result = left;
+            result.isNegative = false;
+            uint64_t carry = right;
+            for (size_t i = result.number.size(); i-- > 0 && carry != 0;) {
+                uint64_t sum = result.number[i] + carry % 1000000000;
+                carry = carry / 1000000000 + sum / 1000000000;
+                result.number[i] = sum % 1000000000;
             }
+            for (; carry != 0; carry /= 1000000000) result.number.push_front(carry % 1000000000);
+            return result;
+        }
 
-            return false;
+        //PRECONDITION: |left| >= right (sign is ignored)
+        inline BigInteger unsignedSubtractSmall(const BigInteger& left, uint64_t right) const {
+            BigInteger result = left;
+            result.isNegative = false;
+            uint64_t borrow = right;
+            for (size_t i = result.number.size(); i-- > 0 && borrow != 0;) {
+                uint32_t block = borrow % 1000000000;
+                borrow /= 1000000000;
+                if (result.number[i] >= block) {
+                    result.number[i] -= block;
+                } else {
+                    result.number[i] += 1000000000 - block;
+                    borrow++;
+                }
+            }
+            return result.trimLeadingZeros();
+        }
+
+        // helpers for the native integer operands, they are split into a sign and an unsigned magnitude
+        template <class T>
+        inline static bool isNegativeValue(T val) {
+            if constexpr (std::is_signed<T>::value) return val < 0;
+            else
+                return false;
+        }
+
+        template <class T>
+        inline static uint64_t magnitudeOf(T val) {
+            if constexpr (std::is_signed<T>::value) return val < 0 ? -uint64_t(val) : uint64_t(val);
+            else
+                return uint64_t(val);
+        }
+
+        inline static BigInteger fromMagnitude(bool negative, uint64_t magnitude) {
+            BigInteger result = magnitude;
+            result.isNegative = negative && magnitude != 0;
+            return result;
+        }
+
+        // this + (negative ? -magnitude : magnitude) without a temporary BigInteger
+        inline BigInteger addMagnitude(bool negative, uint64_t magnitude) const {
+            int64_t vLeft, sum;
+            if (magnitude <= uint64_t(INT64_MAX) && toSmall(vLeft) &&
+                !__builtin_add_overflow(vLeft, negative ? -int64_t(magnitude) : int64_t(magnitude), &sum)) {
+                return sum;
+            }
+            if (number.size() <= 3) return *this + fromMagnitude(negative, magnitude);
+
+            // |this| >= 10^27 > magnitude, so the result keeps the sign of this
+            BigInteger result = isNegative == negative ? unsignedAddSmall(*this, magnitude)
+                                                       : unsignedSubtractSmall(*this, magnitude);
+            result.isNegative = isNegative;
+            return result;
+        }
+
+        // one or two block kernels, larger operands take the generic path
+        inline BigInteger multiplyMagnitude(bool negative, uint64_t magnitude) const {
+            int64_t vLeft, product;
+            if (magnitude <= uint64_t(INT64_MAX) && toSmall(vLeft) &&
+                !__builtin_mul_overflow(vLeft, negative ? -int64_t(magnitude) : int64_t(magnitude), &product)) {
+                return product;
+            }
+            if (number.size() == 0 || magnitude >= uint64_t(1000000000) * 1000000000) {
+                return *this * fromMagnitude(negative, magnitude);
+            }
+
+            BigInteger result = unsignedMultiplySmall(*this, magnitude % 1000000000);
+            if (magnitude >= 1000000000 && !isZero()) {
+                BigInteger high = unsignedMultiplySmall(*this, magnitude / 1000000000);
+                high.number.push_back(0);
+                result = unsignedAdd(high, result).trimLeadingZeros();
+            }
+            result.isNegative = !result.isZero() && isNegative != negative;
+            return result;
+        }
+
+        // {quotient, remainder} with the same signs as operator/ and operator%
+        inline std::pair<BigInteger, BigInteger> divideMagnitude(bool negative, uint64_t magnitude) const {
+            if (magnitude == 0) throw std::invalid_argument("Cannot divide by zero");
+            int64_t vLeft;
+            if (magnitude <= uint64_t(INT64_MAX) && toSmall(vLeft)) {
+                uint64_t uLeft = vLeft < 0 ? -uint64_t(vLeft) : uint64_t(vLeft);
+                return {fromMagnitude(isNegative != negative, uLeft / magnitude), uLeft % magnitude};
+            }
+            if (magnitude >= 1000000000) {
+                auto result = unsignedDivide(*this, magnitude);
+                result.first.isNegative = !result.first.isZero() && isNegative != negative;
+                return result;
+            }
+
+            auto result = unsignedDivideSmall(*this, magnitude);
+            result.first.isNegative = !result.first.isZero() && isNegative != negative;
+            return {result.first, result.second};
+        }
+
+        // -1, 0 or 1 as this compares to (negative ? -magnitude : magnitude)
+        inline int compareMagnitude(bool negative, uint64_t magnitude) const {
+            negative = negative && magnitude != 0;
+            uint64_t own = 0;
+            for (auto token : number) {
+                // larger than any native magnitude
+                if (__builtin_mul_overflow(own, uint64_t(1000000000), &own)) return isNegative ? -1 : 1;
+                if (__builtin_add_overflow(own, token, &own)) return isNegative ? -1 : 1;
+            }
+            bool ownNegative = isNegative && own != 0;
+            if (ownNegative != negative) return ownNegative ? -1 : 1;
+            if (own == magnitude) return 0;
+            return (own < magnitude) != negative ? -1 : 1;
         }
 
     public:
+        // karatsuba splits of operands with at least this many blocks hand their sub-products to the
+        // executor, smaller ones stay on the calling thread
+        static inline size_t parallelThreshold = 2000;
+
+        // divisor and quotient length (blocks) from where a reciprocal beats long division
+        static inline size_t newtonDivideThreshold = 150;
+
+        // multiplication uses this many threads (the calling thread included), 0 or 1 multiplies serially.
+        // must not be changed while a multiplication is running.
+        inline static void setMultiplyThreads(size_t threads) {
+            executor = nullptr;
+            pool.reset(threads > 1 ? new ThreadPool(threads - 1) : nullptr);
+            if (pool) executor = [](const std::vector<std::function<void()>>& tasks) { pool->run(tasks); };
+        }
+
+        // a user supplied executor instead of the built in pool, nullptr multiplies serially
+        inline static void setExecutor(Executor newExecutor) {
+            pool.reset();
+            executor = newExecutor;
+        }
+
         //Constructors
         inline BigInteger() { this->operator=(int64_t(0)); };
         inline BigInteger(std::nullptr_t){};
@@ -322,6 +1262,7 @@ namespace estd {
 
         inline BigInteger& operator=(std::string strNum) {
             number.clear();
+            binaryMirror.reset();
 
             if (strNum.size() == 0) throw std::invalid_argument("Cannot parse BigInteger");
 
@@ -346,21 +1287,20 @@ namespace estd {
 
         inline BigInteger& operator=(intmax_t n) {
             number.clear();
+            binaryMirror.reset();
 
             if (n == 0) {
+                isNegative = false;
                 number.push_front(0);
                 return *this;
             }
 
-            isNegative = false;
-            if (n < 0) {
-                n = -n;
-                isNegative = true;
-            }
+            isNegative = n < 0;
+            uintmax_t magnitude = isNegative ? -uintmax_t(n) : uintmax_t(n);
 
-            while (n != 0) {
-                number.push_front(n % 1000000000);
-                n /= 1000000000;
+            while (magnitude != 0) {
+                number.push_front(magnitude % 1000000000);
+                magnitude /= 1000000000;
             }
 
             return *this;
@@ -368,8 +1308,10 @@ namespace estd {
 
         inline BigInteger& operator=(uintmax_t n) {
             number.clear();
+            binaryMirror.reset();
 
             if (n == 0) {
+                isNegative = false;
                 number.push_front(0);
                 return *this;
             }
@@ -396,6 +1338,11 @@ namespace estd {
         //Operations
         inline BigInteger operator+(const BigInteger& right) const {
             const BigInteger& left = *this;
+            int64_t vLeft, vRight, sum;
+            if (left.toSmall(vLeft) && right.toSmall(vRight) && !__builtin_add_overflow(vLeft, vRight, &sum)) {
+                return sum;
+            }
+
             BigInteger result;
 
             if (left.isNegative && right.isNegative) {
@@ -416,6 +1363,12 @@ namespace estd {
 
         inline BigInteger& operator+=(const BigInteger& right) { return (*this) = (*this) + right; }
 
+        inline BigInteger operator-() const {
+            BigInteger result = *this;
+            result.isNegative = !isNegative && !isZero();
+            return result;
+        }
+
         inline BigInteger operator-(BigInteger right) const {
             right.isNegative = !right.isNegative;
             return operator+(right);
@@ -425,6 +1378,11 @@ namespace estd {
 
         inline BigInteger operator*(BigInteger right) const {
             const BigInteger& left = *this;
+            int64_t vLeft, vRight, product;
+            if (left.toSmall(vLeft) && right.toSmall(vRight) && !__builtin_mul_overflow(vLeft, vRight, &product)) {
+                return product;
+            }
+
             BigInteger result;
 
             if (left.isZero()) return left;
@@ -438,8 +1396,13 @@ namespace estd {
 
         inline BigInteger& operator*=(const BigInteger& right) { return (*this) = (*this) * right; }
 
-        inline BigInteger operator/(const BigInteger& right) {
-            BigInteger& left = *this;
+        inline BigInteger operator/(const BigInteger& right) const {
+            const BigInteger& left = *this;
+            int64_t vLeft, vRight;
+            if (left.toSmall(vLeft) && right.toSmall(vRight)) {
+                if (vRight == 0) throw std::invalid_argument("Cannot divide by zero");
+                return vLeft / vRight;
+            }
 
             auto result = unsignedDivide(left, right);
             if (left.isNegative != right.isNegative) result.first.isNegative = true;
@@ -450,8 +1413,13 @@ namespace estd {
 
         inline BigInteger& operator/=(const BigInteger& right) { return (*this) = (*this) / right; }
 
-        inline BigInteger operator%(const BigInteger& right) {
-            BigInteger& left = *this;
+        inline BigInteger operator%(const BigInteger& right) const {
+            const BigInteger& left = *this;
+            int64_t vLeft, vRight;
+            if (left.toSmall(vLeft) && right.toSmall(vRight)) {
+                if (vRight == 0) throw std::invalid_argument("Cannot divide by zero");
+                return uint64_t(vLeft < 0 ? -vLeft : vLeft) % uint64_t(vRight < 0 ? -vRight : vRight);
+            }
 
             auto result = unsignedDivide(left, right);
             if (left.isNegative != right.isNegative) result.first.isNegative = true;
@@ -461,8 +1429,59 @@ namespace estd {
 
         inline BigInteger& operator%=(const BigInteger& right) { return (*this) = (*this) % right; }
 
+        // native integer operands skip the temporary BigInteger and use one or two block kernels
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigInteger operator+(T right) const {
+            return addMagnitude(isNegativeValue(right), magnitudeOf(right));
+        }
+
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigInteger operator-(T right) const {
+            return addMagnitude(!isNegativeValue(right), magnitudeOf(right));
+        }
+
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigInteger operator*(T right) const {
+            return multiplyMagnitude(isNegativeValue(right), magnitudeOf(right));
+        }
+
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigInteger operator/(T right) const {
+            return divideMagnitude(isNegativeValue(right), magnitudeOf(right)).first;
+        }
+
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigInteger operator%(T right) const {
+            return divideMagnitude(isNegativeValue(right), magnitudeOf(right)).second;
+        }
+
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigInteger& operator+=(T right) {
+            return (*this) = (*this) + right;
+        }
+
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigInteger& operator-=(T right) {
+            return (*this) = (*this) - right;
+        }
+
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigInteger& operator*=(T right) {
+            return (*this) = (*this) * right;
+        }
+
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigInteger& operator/=(T right) {
+            return (*this) = (*this) / right;
+        }
+
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigInteger& operator%=(T right) {
+            return (*this) = (*this) % right;
+        }
+
         inline BigInteger power(BigInteger p) const {
-            if (p == 0) return 0;
+            if (p == 0) return 1;
             // auto result = powerIterative(*this, p);
             std::map<BigInteger, BigInteger> history = {{1, *this}, {0, 1}};
             auto result = powerRecursive(p, history);
@@ -472,8 +1491,325 @@ namespace estd {
             return result;
         }
 
+        // square and multiply over the bits of a native exponent
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigInteger power(T p) const {
+            if (isNegativeValue(p)) return power(BigInteger(p));
+            BigInteger result = 1;
+            BigInteger base = *this;
+            for (uint64_t exponent = magnitudeOf(p); exponent != 0; exponent >>= 1) {
+                if (exponent & 1) result *= base;
+                if (exponent > 1) base *= base;
+            }
+            return result;
+        }
+
         // BigInteger power(BigDecimal p) const;
 
+        // floor(sqrt(this))
+        inline BigInteger isqrt() const {
+            if (number.size() == 0) throw std::invalid_argument("Cannot take the root of nan");
+            if (isNegative && !isZero()) {
+                throw std::invalid_argument("Cannot take the square root of a negative number");
+            }
+            return unsignedSqrt(*this);
+        }
+
+        // the k-th root rounded toward zero, negative values only have odd roots
+        inline BigInteger iroot(size_t k) const {
+            if (number.size() == 0) throw std::invalid_argument("Cannot take the root of nan");
+            if (k == 0) throw std::invalid_argument("Cannot take the zeroth root");
+            if (isNegative && !isZero() && k % 2 == 0) {
+                throw std::invalid_argument("Cannot take an even root of a negative number");
+            }
+            if (k == 1) return *this;
+            BigInteger result = unsignedRoot(*this, k);
+            result.isNegative = isNegative && !result.isZero();
+            return result;
+        }
+
+        inline bool isPerfectSquare() const {
+            if (number.size() == 0) return false;
+            if (isNegative && !isZero()) return false;
+            return isUnsignedSquare(*this);
+        }
+
+        // true when this is r^k for some integer r and k >= 2 (0, 1 and -1 are). Only prime exponents are
+        // tried: a short root is guessed from the logarithm and checked modulo a few primes before it is
+        // raised to the power, a long one is only computed when this is a power residue modulo p.
+        inline bool isPerfectPower() const {
+            if (number.size() == 0) return false;
+            if (number.size() == 1 && number[0] <= 1) return true;
+
+            size_t digits = getNumDigits();
+            std::vector<uint64_t> exponents = primesUpTo(uint64_t(digits * 3.33) + 1);
+            if (isNegative) exponents.erase(exponents.begin());
+
+            // the guessed short roots are checked modulo three fixed primes, every long root exponent gets a
+            // first residue test. all of them come from one pass over the blocks.
+            std::vector<uint64_t> moduli = {4294967291, 4294967279, 4294967231};
+            for (uint64_t p : exponents) {
+                if (p > 2 && digits >= 12 * p) moduli.push_back(residueModulus(p, 0));
+            }
+            std::vector<uint64_t> residues = unsignedModuli(*this, moduli);
+
+            long double logarithm = logarithm10(*this);
+            size_t next = 3;
+            for (uint64_t p : exponents) {
+                if (digits < 12 * p) { // the root is below 10^12
+                    uint64_t guess = uint64_t(std::llround(std::pow(10.0L, logarithm / p)));
+                    for (uint64_t root = guess > 2 ? guess - 1 : 2; root <= guess + 1; root++) {
+                        bool candidate = true;
+                        for (size_t i = 0; i < 3 && candidate; i++) {
+                            candidate = powerModulo(root, p, moduli[i]) == residues[i];
+                        }
+                        if (candidate && isMagnitudeEqual(BigInteger(root).power(p), *this)) return true;
+                    }
+                } else if (p == 2) {
+                    if (isUnsignedSquare(*this)) return true;
+                } else {
+                    uint64_t q = moduli[next];
+                    if (isPowerResidue(residues[next++], p, q) && mayBePower(*this, p, q) &&
+                        isMagnitudeEqual(unsignedRoot(*this, p).power(p), *this)) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // greatest common divisor of the magnitudes (euclid), gcd(0, 0) is 0
+        inline static BigInteger gcd(BigInteger a, BigInteger b) {
+            a.isNegative = b.isNegative = false;
+            int64_t vA, vB;
+            while (!b.isZero()) {
+                if (a.toSmall(vA) && b.toSmall(vB)) return std::gcd(vA, vB);
+                a = a % b;
+                std::swap(a, b);
+            }
+            return a;
+        }
+
+        // the inverse of this modulo |m| in [0, |m|) by the extended euclidean algorithm, throws when the
+        // value and the modulus have a common factor
+        inline BigInteger modInverse(const BigInteger& m) const {
+            BigInteger a = *this % m;
+            if (isNegative && !a.isZero()) a = unsignedSubtract(m, a);
+            BigInteger modulus = m;
+            modulus.isNegative = false;
+
+            // s * a = r (mod m) holds for both pairs
+            int64_t vM, vA;
+            if (modulus.toSmall(vM) && a.toSmall(vA)) {
+                int64_t oldR = vM, r = vA, oldS = 0, s = 1;
+                while (r != 0) {
+                    int64_t q = oldR / r;
+                    oldR = std::exchange(r, oldR - q * r);
+                    oldS = std::exchange(s, oldS - q * s);
+                }
+                if (oldR != 1) throw std::invalid_argument("Value is not invertible modulo m");
+                return oldS < 0 ? oldS + vM : oldS;
+            }
+            BigInteger oldR = modulus, r = a, oldS = 0, s = 1;
+            while (!r.isZero()) {
+                BigInteger q = oldR / r;
+                oldR = std::exchange(r, oldR - q * r);
+                oldS = std::exchange(s, oldS - q * s);
+            }
+            if (oldR != 1) throw std::invalid_argument("Value is not invertible modulo m");
+            return oldS < 0 ? oldS + modulus : oldS;
+        }
+
+        // this^exponent mod |m| in [0, |m|), a negative exponent raises the inverse. Moduli coprime to 10 work in
+        // montgomery form, the others square and divide.
+        inline BigInteger modPow(const BigInteger& exponent, const BigInteger& m) const {
+            if (number.size() == 0 || exponent.number.size() == 0) throw std::invalid_argument("Cannot raise nan");
+            if (m.isZero()) throw std::invalid_argument("Cannot reduce modulo zero");
+            if (exponent.isNegative && !exponent.isZero()) return modInverse(m).modPow(-exponent, m);
+            BigInteger modulus = m;
+            modulus.isNegative = false;
+            BigInteger base = *this % modulus;
+            if (isNegative && !base.isZero()) base = unsignedSubtract(modulus, base);
+            if (modulus == 1) return 0;
+
+            uint32_t low = modulus.number[modulus.number.size() - 1];
+            if (low % 2 != 0 && low % 5 != 0) {
+                Montgomery field(modulus.number.begin(), modulus.number.size());
+                Residue one = toMontgomery(field, 1, modulus);
+                return fromMontgomery(field, montgomeryPower(field, toMontgomery(field, base, modulus), exponent, one));
+            }
+            BigInteger result = 1;
+            for (size_t bit = exponent.bitLength(); bit-- > 0;) {
+                result = result * result % modulus;
+                if (exponent.testBit(bit)) result = result * base % modulus;
+            }
+            return result;
+        }
+
+        // false for composites, true for primes and (no example is known) for baillie-psw pseudoprimes. Trial
+        // division by the primes below 2000 comes first, then a miller-rabin round to the base 2, a strong lucas
+        // test and rounds more miller-rabin rounds to the bases 3, 5, 7, 11, ... Negative values, 0 and 1 are
+        // not prime.
+        inline bool isProbablePrime(size_t rounds = 0) const {
+            uint64_t base = 1;
+            return isProbablePrimeWith(rounds, [&] {
+                for (base += 2; !isSmallPrime(base);) base += 2;
+                return BigInteger(base);
+            });
+        }
+
+        // as above, the extra rounds use uniform random bases from rng
+        template <class Generator>
+        inline bool isProbablePrime(size_t rounds, Generator& rng) const {
+            return isProbablePrimeWith(rounds, [&] { return randomBelow(*this - 3, rng) + 2; });
+        }
+
+        // the smallest (probable) prime above this. The odd candidates are sieved by the trial primes in windows,
+        // only the residues of a window's start need a pass over the blocks.
+        inline BigInteger nextPrime() const {
+            if (number.size() == 0) throw std::invalid_argument("Cannot search from nan");
+            if (isNegative || *this < 2) return 2;
+            int64_t small;
+            if (toSmall(small) && uint64_t(small) < trialDivisionBound) {
+                for (uint64_t candidate = small + 1;; candidate++) {
+                    if (isSmallPrime(candidate)) return candidate;
+                }
+            }
+
+            // candidate + 2i is a multiple of p for i = -candidate / 2 (mod p)
+            const std::vector<uint64_t>& primes = trialDivisors().primes;
+            constexpr size_t window = 4096;
+            BigInteger candidate = unsignedAddSmall(*this, number[number.size() - 1] % 2 == 0 ? 1 : 2);
+            while (true) {
+                std::vector<uint64_t> residues = trialResidues(candidate);
+                std::vector<uint8_t> composite(window, 0);
+                for (size_t j = 0; j < primes.size(); j++) {
+                    uint64_t p = primes[j];
+                    for (uint64_t i = (p - residues[j]) * ((p + 1) / 2) % p; i < window; i += p) composite[i] = 1;
+                }
+                for (size_t i = 0; i < window; i++) {
+                    if (composite[i]) continue;
+                    BigInteger value = unsignedAddSmall(candidate, 2 * i);
+                    if (value.toSmall(small) && uint64_t(small) < trialDivisionBound * trialDivisionBound) return value;
+                    if (isBailliePSWPrime(value)) return value;
+                }
+                candidate = unsignedAddSmall(candidate, 2 * window);
+            }
+        }
+
+        // uniform in [0, 10^digits)
+        template <class Generator>
+        inline static BigInteger random(size_t digits, Generator& rng) {
+            if (digits == 0) return 0;
+            size_t blocks = (digits + 8) / 9;
+            BlockBuffer result(blocks, 0);
+            fillRandom(result, 0, rng);
+            // 10^k divides the base, so the head stays uniform
+            result[0] %= decimalblocks::powersOfTen[digits - 9 * (blocks - 1)];
+            return BigInteger(std::move(result)).trimLeadingZeros();
+        }
+
+        // uniform in [0, 2^bits)
+        template <class Generator>
+        inline static BigInteger randomBits(size_t bits, Generator& rng) {
+            return randomBelow(BigInteger(2).power(bits), rng);
+        }
+
+        // uniform in [0, bound) for a positive bound. The blocks are drawn from the most significant one, while
+        // they match the bound's a larger block starts the draw over and the first smaller one leaves the rest
+        // free. The two leading blocks are drawn as one value below the bound's, so a restart is rare.
+        template <class Generator>
+        inline static BigInteger randomBelow(const BigInteger& bound, Generator& rng) {
+            if (bound.number.size() == 0 || bound.isNegative || bound.isZero()) {
+                throw std::invalid_argument("The bound must be positive");
+            }
+            const BlockBuffer& limit = bound.number;
+            size_t n = limit.size();
+            size_t headBlocks = std::min<size_t>(n, 2);
+            uint64_t head = headBlocks == 2 ? uint64_t(limit[0]) * decimalblocks::base + limit[1] : limit[0];
+            BlockBuffer result(n, 0);
+            while (true) {
+                uint64_t drawn = std::uniform_int_distribution<uint64_t>(0, head)(rng);
+                result[0] = uint32_t(headBlocks == 2 ? drawn / decimalblocks::base : drawn);
+                if (headBlocks == 2) result[1] = uint32_t(drawn % decimalblocks::base);
+                bool below = drawn < head;
+                size_t i = headBlocks;
+                for (; !below && i < n; i++) {
+                    result[i] = uint32_t(randomBlockPair(rng) % decimalblocks::base);
+                    if (result[i] > limit[i]) break;
+                    below = result[i] < limit[i];
+                }
+                if (!below) continue;
+                fillRandom(result, i, rng);
+                return BigInteger(std::move(result)).trimLeadingZeros();
+            }
+        }
+
+        // a (probable) prime with the given number of digits: a uniform draw moved to the next prime, drawn
+        // again when either one has another length. rng is any uniform random bit generator.
+        template <class Generator>
+        inline static BigInteger randomPrime(size_t digits, Generator& rng) {
+            if (digits == 0) throw std::invalid_argument("A prime has at least one digit");
+            while (true) {
+                BigInteger start = random(digits, rng);
+                if (start.getNumDigits() != digits) continue;
+                BigInteger prime = (start - 1).nextPrime();
+                if (prime.getNumDigits() == digits) return prime;
+            }
+        }
+
+        // product of a range of values (anything a BigInteger converts from) as a balanced product tree
+        template <class Iterator>
+        inline static BigInteger product(Iterator first, Iterator last) {
+            std::vector<BigInteger> values(first, last);
+            return productTree(values.data(), values.size());
+        }
+
+        inline static BigInteger product(const std::vector<BigInteger>& values) {
+            return productTree(values.data(), values.size());
+        }
+
+        // low * (low + 1) * ... * high, 1 for an empty range
+        inline static BigInteger rangeProduct(uint64_t low, uint64_t high) {
+            if (low > high) return 1;
+            if (low == 0) return 0;
+            std::vector<uint64_t> factors;
+            factors.reserve(high - low + 1);
+            for (uint64_t factor = low;; factor++) {
+                factors.push_back(factor);
+                if (factor == high) break;
+            }
+            std::vector<BigInteger> packed = packFactors(factors);
+            return productTree(packed.data(), packed.size());
+        }
+
+        // n! from its prime factorization (see primePowerProduct)
+        inline static BigInteger factorial(uint64_t n) {
+            std::vector<uint64_t> primes = primesUpTo(n), exponents;
+            for (auto p : primes) exponents.push_back(factorialExponent(n, p));
+            return primePowerProduct(primes, exponents);
+        }
+
+        // n choose k, 0 for k > n. the prime exponents need a sieve up to n, beyond that the range
+        // n - k + 1 .. n is divided by k!
+        inline static BigInteger binomial(uint64_t n, uint64_t k) {
+            if (k > n) return 0;
+            k = std::min(k, n - k);
+            if (n > (uint64_t(1) << 28)) return rangeProduct(n - k + 1, n) / factorial(k);
+
+            std::vector<uint64_t> primes = primesUpTo(n), exponents;
+            for (auto p : primes) {
+                exponents.push_back(factorialExponent(n, p) - factorialExponent(k, p) - factorialExponent(n - k, p));
+            }
+            return primePowerProduct(primes, exponents);
+        }
+
+        // the product of the primes up to n
+        inline static BigInteger primorial(uint64_t n) {
+            std::vector<BigInteger> packed = packFactors(primesUpTo(n));
+            return productTree(packed.data(), packed.size());
+        }
+
         inline BigInteger operator++(int) {
             BigInteger oldThis = *this;
             *this = *this + 1;
@@ -520,6 +1856,8 @@ namespace estd {
 
         inline bool operator<(const BigInteger& right) const {
             const BigInteger& left = *this;
+            int64_t vLeft, vRight;
+            if (left.toSmall(vLeft) && right.toSmall(vRight)) return vLeft < vRight;
             if (left == right) return false;
             if (left.isNegative && !right.isNegative) return true;
             else if (!left.isNegative && right.isNegative)
@@ -534,38 +1872,85 @@ namespace estd {
             return !(left > right);
         }
 
-        //TODO: implement power function and optimize this using divide and conq.
-        inline BigInteger& operator<<=(const BigInteger& right) {
-            BigInteger& result = *this;
-            for (BigInteger i = 0; i < right; i++) { result = unsignedMultiply(result, BigInteger(2)); }
-            if (result.number.size() == 0) result.number.push_front(0);
-            return result;
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline bool operator==(T right) const {
+            return number.size() != 0 && compareMagnitude(isNegativeValue(right), magnitudeOf(right)) == 0;
         }
 
-        //TODO: implement power function and optimize this using divide and conq.
-        inline BigInteger& operator>>=(const BigInteger& right) {
-            BigInteger& result = *this;
-            for (BigInteger i = 0; i < right; i++) {
-                //essentially we multiply by 5/10 using clever tricks
-                result = unsignedMultiply(result, BigInteger(5 * (1000000000 / 10)));
-                result.number.pop_back(); // divides by 1000000000
-            }
-            if (result.number.size() == 0) result.number.push_front(0);
-            return result;
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline bool operator!=(T right) const {
+            return !(operator==(right));
         }
 
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline bool operator<(T right) const {
+            return compareMagnitude(isNegativeValue(right), magnitudeOf(right)) < 0;
+        }
+
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline bool operator>(T right) const {
+            return compareMagnitude(isNegativeValue(right), magnitudeOf(right)) > 0;
+        }
+
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline bool operator<=(T right) const {
+            return compareMagnitude(isNegativeValue(right), magnitudeOf(right)) <= 0;
+        }
+
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline bool operator>=(T right) const {
+            return compareMagnitude(isNegativeValue(right), magnitudeOf(right)) >= 0;
+        }
+
+        inline BigInteger& operator<<=(const BigInteger& right) { return (*this) = (*this) << right; }
+        inline BigInteger& operator>>=(const BigInteger& right) { return (*this) = (*this) >> right; }
+
+        // this * 2^right, a multiply by a power of two on the decimal blocks (cheaper than two base
+        // conversions), the sign is kept
         inline BigInteger operator<<(const BigInteger& right) const {
-            BigInteger result = *this;
-            result <<= right;
+            if (number.size() == 0 || right <= 0 || isZero()) return *this;
+            size_t shift = size_t(right.toUint());
+            BigInteger result = shift <= 256 ? unsignedMultiplyPower(*this, 2, shift)
+                                             : unsignedMultiply(*this, BigInteger(2).power(shift));
+            result.isNegative = isNegative;
             return result;
         }
 
+        // this / 2^right rounded toward negative infinity, like the two's complement shift of BigBinaryInteger
         inline BigInteger operator>>(const BigInteger& right) const {
-            BigInteger result = *this;
-            result >>= right;
+            if (number.size() == 0 || right <= 0) return *this;
+            size_t shift = size_t(right.toUint());
+            BigInteger result;
+            bool exact;
+            if (shift <= 256) {
+                auto qr = unsignedDividePower(*this, 2, shift);
+                result = qr.first;
+                exact = qr.second;
+            } else {
+                auto qr = unsignedDivide(*this, BigInteger(2).power(shift));
+                result = qr.first;
+                exact = qr.second.isZero();
+            }
+            bool negative = isNegative && !isZero();
+            if (negative && !exact) result = unsignedAdd(result, 1);
+            result.isNegative = negative && !result.isZero();
             return result;
         }
 
+        //Bitwise operations, on the cached binary form with two's complement semantics (see BigBinaryInteger).
+        //The results stay binary until they are used as a BigInteger, so mask and shift chains convert once.
+        inline BigBinaryInteger toBinary() const;
+        inline BigBinaryInteger operator&(const BigInteger& right) const;
+        inline BigBinaryInteger operator|(const BigInteger& right) const;
+        inline BigBinaryInteger operator^(const BigInteger& right) const;
+        inline BigBinaryInteger operator~() const;
+        inline BigInteger& operator&=(const BigInteger& right);
+        inline BigInteger& operator|=(const BigInteger& right);
+        inline BigInteger& operator^=(const BigInteger& right);
+        inline bool testBit(size_t bit) const;
+        // bits of the magnitude
+        inline size_t bitLength() const;
+
         inline friend std::ostream& operator<<(std::ostream& out, const BigInteger& right) {
             return out << right.toString();
         }
@@ -574,8 +1959,8 @@ namespace estd {
         inline uintmax_t toUint() const {
             uintmax_t result = 0;
             if (number.size() >= 1) result += number[number.size() - 1];
-            if (number.size() >= 2) result += number[number.size() - 2] * 1000000000;
-            if (number.size() >= 3) result += number[number.size() - 3] * 1000000000 * 1000000000;
+            if (number.size() >= 2) result += uintmax_t(number[number.size() - 2]) * 1000000000;
+            if (number.size() >= 3) result += uintmax_t(number[number.size() - 3]) * 1000000000 * 1000000000;
             return result;
         }
         inline intmax_t toInt() const {
@@ -606,31 +1991,62 @@ namespace estd {
             }
             return ss.str();
         }
-        inline size_t getNumDigits() {
+        inline size_t hash() const {
+            if (number.size() == 0) return 0;
+            if (isZero()) return std::hash<uint32_t>{}(0);
+            size_t result = isNegative;
+            for (auto token : number) {
+                result ^= std::hash<uint32_t>{}(token) + 0x9e3779b97f4a7c15ULL + (result << 6) + (result >> 2);
+            }
+            return result;
+        }
+
+        inline size_t getNumDigits() const {
             if (number.size() < 1) return 0;
             size_t result = 0;
             result = (number.size() - 1) * 9;
-            uint64_t tmp = number[0];
-            for (int i = 0; i < 9; i++) {
-                if (tmp != 0) result++;
-                tmp /= 10;
-            }
+            for (size_t i = 1; i < 10 && number[0] >= decimalblocks::powersOfTen[i - 1]; i++) result++;
             if (result <= 0) result = 1;
             return result;
         }
 
-        operator BigDecimal();
+        // 10^n, built directly from blocks
+        inline static BigInteger powerOfTen(size_t n) {
+            BigInteger result = BlockBuffer(n / 9 + 1, 0);
+            result.number[0] = decimalblocks::powersOfTen[n % 9];
+            return result;
+        }
+
+        // builds a value from base 1000000000 blocks, most significant block first
+        inline static BigInteger fromBlocks(const uint32_t* blocks, size_t n, bool negative = false) {
+            BigInteger result = BlockBuffer(blocks, blocks + n);
+            result.trimLeadingZeros();
+            result.isNegative = negative && !result.isZero();
+            return result;
+        }
 
-        // TODO:
-        // DEFINE_BIN_OP(^) // makes no sense for long ints, will just be all 1s  if we assume leading zeros
-        // DEFINE_BIN_OP(&) // can be done, but hard for the stored format, will be slow
-        // DEFINE_BIN_OP(|) // can be done, but hard for the stored format, will be slow
-        // DEFINE_UNARY_OP(~) // makes no sense for long ints, will just be all 1s if we assume leading zeros
-        // DEFINE_BIN_OP(^=) // makes no sense for long ints, will just be all 1s  if we assume leading zeros
-        // DEFINE_BIN_OP(&=) // can be done, but hard for the stored format, will be slow
-        // DEFINE_BIN_OP(|=) // can be done, but hard for the stored format, will be slow
+        operator BigDecimal();
     };
     typedef BigInteger BigInt;
+
+    inline namespace literals {
+        // 123456789012345678901234567890_bi (or 0x..., 0b..., octal), the digits are parsed at compile time
+        // into blocks, at runtime the value is only copied
+        template <char... Chars>
+        inline BigInteger operator""_bi() {
+            static constexpr char str[] = {Chars...};
+            static constexpr size_t blocks = decimalblocks::literalBlocks(str, sizeof...(Chars));
+            static constexpr auto parsed = decimalblocks::parseLiteral<blocks>(str, sizeof...(Chars));
+            static_assert(parsed.isValid && parsed.isInteger, "_bi needs an integer literal");
+            return BigInteger::fromBlocks(parsed.blocks + parsed.offset, blocks - parsed.offset);
+        }
+    } // namespace literals
 } // namespace estd
 
-#include <estd/BigDecimal.h> // correct order
\ No newline at end of file
+template <>
+struct std::hash<estd::BigInteger> {
+    inline size_t operator()(const estd::BigInteger& val) const { return val.hash(); }
+};
+
+#include <estd/BigBinaryInteger.h> // correct order
+#include <estd/BigDecimal.h>
\ No newline at end of file
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <estd/BigInteger.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace estd {
+    // Column of BigIntegers in one contiguous block pool (structure of arrays): element i owns the blocks
+    // [offsets[i], offsets[i + 1]), most significant first like BigInteger, plus a sign byte. The batch
+    // kernels walk the pool linearly and split large columns over BigInteger's executor
+    // (BigInteger::setMultiplyThreads / setExecutor), every chunk writes its own output so results do not
+    // depend on the scheduling.
+    class BigIntegerArray {
+        friend class BigDecimalArray;
+
+    protected:
+        std::vector<uint32_t> blocks;
+        std::vector<size_t> offsets = {0};
+        std::vector<uint8_t> negative;
+
+        // elements per parallel chunk
+        static constexpr size_t chunkSize = 4096;
+
+        // runs f(begin, end, chunk) over [0, n), in parallel when an executor is set and n is large enough
+        template <class F>
+        inline static size_t forChunks(size_t n, F&& f) {
+            size_t chunks = BigInteger::executor ? std::min<size_t>((n + chunkSize - 1) / chunkSize, 256) : 1;
+            if (chunks <= 1) {
+                f(size_t(0), n, size_t(0));
+                return 1;
+            }
+            std::vector<std::function<void()>> tasks;
+            for (size_t c = 0; c < chunks; c++) {
+                size_t begin = n * c / chunks;
+                size_t end = n * (c + 1) / chunks;
+                tasks.push_back([&f, begin, end, c] { f(begin, end, c); });
+            }
+            BigInteger::executor(tasks);
+            return chunks;
+        }
+
+        inline const uint32_t* data(size_t i) const { return blocks.data() + offsets[i]; }
+        inline size_t length(size_t i) const { return offsets[i + 1] - offsets[i]; }
+
+        inline void append(const BigIntegerArray& other) {
+            size_t base = blocks.size();
+            blocks.insert(blocks.end(), other.blocks.begin(), other.blocks.end());
+            for (size_t i = 1; i < other.offsets.size(); i++) offsets.push_back(base + other.offsets[i]);
+            negative.insert(negative.end(), other.negative.begin(), other.negative.end());
+        }
+
+        // plain decimal strings are cut into blocks directly, anything else goes through BigInteger
+        inline void appendParsed(const std::string& str) {
+            size_t start = !str.empty() && str[0] == '-';
+            bool plain = str.size() > start;
+            for (size_t i = start; plain && i < str.size(); i++) plain = str[i] >= '0' && str[i] <= '9';
+            if (!plain) {
+                push_back(BigInteger(str));
+                return;
+            }
+            while (start + 1 < str.size() && str[start] == '0') start++;
+
+            size_t digits = str.size() - start;
+            size_t head = digits % 9 == 0 ? 9 : digits % 9;
+            size_t position = start;
+            for (size_t width = head; position < str.size(); width = 9) {
+                uint32_t block = 0;
+                for (size_t end = position + width; position < end; position++) {
+                    block = block * 10 + (str[position] - '0');
+                }
+                blocks.push_back(block);
+            }
+            offsets.push_back(blocks.size());
+            negative.push_back(str[0] == '-' && !(digits == 1 && str[start] == '0'));
+        }
+
+        inline std::string elementString(size_t i) const {
+            const uint32_t* x = data(i);
+            size_t n = length(i);
+            std::string result(negative[i] + n * 9, '0');
+            size_t position = negative[i];
+            if (negative[i]) result[0] = '-';
+            char head[10];
+            size_t headLength = 0;
+            for (uint32_t value = x[0]; headLength == 0 || value != 0; value /= 10) {
+                head[headLength++] = '0' + value % 10;
+            }
+            for (size_t k = headLength; k-- > 0;) result[position++] = head[k];
+            for (size_t b = 1; b < n; b++) {
+                for (size_t k = 9, value = x[b]; k-- > 0; value /= 10) result[position + k] = '0' + value % 10;
+                position += 9;
+            }
+            result.resize(position);
+            return result;
+        }
+
+    public:
+        inline BigIntegerArray() {}
+        inline BigIntegerArray(const std::vector<BigInteger>& values) {
+            for (const auto& value : values) push_back(value);
+        }
+
+        inline size_t size() const { return negative.size(); }
+
+        inline void reserve(size_t elements, size_t totalBlocks) {
+            offsets.reserve(elements + 1);
+            negative.reserve(elements);
+            blocks.reserve(totalBlocks);
+        }
+
+        inline void push_back(const BigInteger& value) {
+            if (value.number.size() == 0) throw std::invalid_argument("Cannot store nan in a BigIntegerArray");
+            blocks.insert(blocks.end(), value.number.begin(), value.number.end());
+            offsets.push_back(blocks.size());
+            negative.push_back(value.isNegative && !value.isZero());
+        }
+
+        inline BigInteger operator[](size_t i) const { return BigInteger::fromBlocks(data(i), length(i), negative[i]); }
+
+        // parses every string (the BigInteger formats), in parallel for large inputs
+        inline static BigIntegerArray parseAll(const std::vector<std::string>& strings) {
+            std::vector<BigIntegerArray> parts(BigInteger::executor ? 256 : 1);
+            size_t chunks = forChunks(strings.size(), [&](size_t begin, size_t end, size_t chunk) {
+                for (size_t i = begin; i < end; i++) parts[chunk].appendParsed(strings[i]);
+            });
+            BigIntegerArray result;
+            for (size_t c = 0; c < chunks; c++) result.append(parts[c]);
+            return result;
+        }
+
+        inline std::vector<std::string> toStrings() const {
+            std::vector<std::string> result(size());
+            forChunks(size(), [&](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; i++) result[i] = elementString(i);
+            });
+            return result;
+        }
+
+        // every block is added into a 64 bit column sum by significance and carried once at the end,
+        // positive and negative elements are summed separately
+        inline BigInteger sum() const {
+            size_t longest = 0;
+            for (size_t i = 0; i < size(); i++) longest = std::max(longest, length(i));
+            std::vector<std::vector<uint64_t>> columns(BigInteger::executor ? 512 : 2);
+            size_t chunks = forChunks(size(), [&](size_t begin, size_t end, size_t chunk) {
+                std::vector<uint64_t>& positive = columns[2 * chunk];
+                std::vector<uint64_t>& negatives = columns[2 * chunk + 1];
+                positive.assign(longest, 0);
+                negatives.assign(longest, 0);
+                for (size_t i = begin; i < end; i++) {
+                    uint64_t* target = negative[i] ? negatives.data() : positive.data();
+                    const uint32_t* x = data(i);
+                    size_t n = length(i);
+                    for (size_t k = 0; k < n; k++) target[k] += x[n - 1 - k];
+                }
+            });
+
+            // a column can take 2^64 / 10^9 additions before it overflows, far more than any array holds
+            BigInteger result = 0;
+            for (size_t sign = 0; sign < 2; sign++) {
+                std::vector<uint64_t> total(longest, 0);
+                for (size_t c = 0; c < chunks; c++) {
+                    for (size_t k = 0; k < longest; k++) total[k] += columns[2 * c + sign][k];
+                }
+                BlockBuffer digits;
+                uint64_t carry = 0;
+                for (size_t k = 0; k < longest; k++) {
+                    uint64_t value = total[k] % decimalblocks::base + carry;
+                    carry = total[k] / decimalblocks::base + value / decimalblocks::base;
+                    digits.push_front(value % decimalblocks::base);
+                }
+                for (; carry != 0; carry /= decimalblocks::base) digits.push_front(carry % decimalblocks::base);
+                BigInteger part = BigInteger::fromBlocks(digits.begin(), digits.size(), sign == 1);
+                if (digits.size() != 0) result += part;
+            }
+            return result;
+        }
+
+        // every element times factor. a single block factor multiplies the whole pool in one pass and then
+        // carries each element, larger factors multiply element by element
+        inline BigIntegerArray mulScalar(const BigInteger& factor) const {
+            if (factor.number.size() == 0) throw std::invalid_argument("Cannot multiply by nan");
+            std::vector<BigIntegerArray> parts(BigInteger::executor ? 256 : 1);
+            bool single = factor.number.size() == 1;
+            uint64_t m = factor.number[factor.number.size() - 1];
+            bool flip = factor.isNegative && !factor.isZero();
+            size_t chunks = forChunks(size(), [&](size_t begin, size_t end, size_t chunk) {
+                BigIntegerArray& part = parts[chunk];
+                if (!single) {
+                    for (size_t i = begin; i < end; i++) part.push_back((*this)[i] * factor);
+                    return;
+                }
+                size_t first = offsets[begin];
+                size_t count = offsets[end] - first;
+                std::vector<uint64_t> wide(count);
+                for (size_t k = 0; k < count; k++) wide[k] = blocks[first + k] * m;
+
+                part.reserve(end - begin, count + (end - begin));
+                for (size_t i = begin; i < end; i++) {
+                    const uint64_t* x = wide.data() + offsets[i] - first;
+                    size_t n = length(i);
+                    size_t start = part.blocks.size();
+                    part.blocks.resize(start + n + 1);
+                    uint64_t carry = 0;
+                    for (size_t k = n; k-- > 0;) {
+                        uint64_t value = x[k] + carry;
+                        part.blocks[start + k + 1] = value % decimalblocks::base;
+                        carry = value / decimalblocks::base;
+                    }
+                    part.blocks[start] = carry;
+                    // drop the leading zero blocks, keep one for zero
+                    size_t skip = 0;
+                    while (skip < n && part.blocks[start + skip] == 0) skip++;
+                    if (skip != 0) part.blocks.erase(part.blocks.begin() + start, part.blocks.begin() + start + skip);
+                    part.offsets.push_back(part.blocks.size());
+                    bool zero = part.blocks.size() - start == 1 && part.blocks[start] == 0;
+                    part.negative.push_back((negative[i] != flip) && !zero);
+                }
+            });
+            BigIntegerArray result;
+            for (size_t c = 0; c < chunks; c++) result.append(parts[c]);
+            return result;
+        }
+
+        // -1, 0 or 1 per element as it compares to threshold
+        inline std::vector<int8_t> compare(const BigInteger& threshold) const {
+            std::vector<int8_t> result(size());
+            bool thresholdNegative = threshold.isNegative && !threshold.isZero();
+            const uint32_t* t = threshold.number.begin();
+            size_t tn = threshold.number.size();
+            auto compareBlocks = decimalblocks::kernels().compare;
+            forChunks(size(), [&](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; i++) {
+                    if (negative[i] != thresholdNegative) {
+                        result[i] = negative[i] ? -1 : 1;
+                        continue;
+                    }
+                    int magnitude = compareBlocks(data(i), length(i), t, tn);
+                    result[i] = int8_t(negative[i] ? -magnitude : magnitude);
+                }
+            });
+            return result;
+        }
+    };
+} // namespace estd
@@ -1,2 +1,11 @@
+#include <estd/BigBinaryInteger.h>
 #include <estd/BigDecimal.h>
-#include <estd/BigInteger.h>
\ No newline at end of file
+#include <estd/BigDecimalAccumulator.h>
+#include <estd/BigDecimalArray.h>
+#include <estd/BigFloat.h>
+#include <estd/BigInteger.h>
+#include <estd/BigIntegerArray.h>
+#include <estd/BigRational.h>
+#include <estd/FixedBigInt.h>
+#include <estd/FixedDecimal.h>
+#include <estd/ProductTree.h>
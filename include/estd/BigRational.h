@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <estd/BigDecimal.h>
+#include <estd/BigInteger.h>
+#include <exception>
+#include <string>
+
+namespace estd {
+    // when a BigRational divides its terms by their gcd
+    enum class ReducePolicy {
+        EAGER,     // after every operation, values are always in lowest terms
+        THRESHOLD, // once a term grows past BigRational::reduceThreshold blocks
+        ON_DEMAND, // only in reduce(), printing and hashing reduce a copy
+    };
+
+    // Exact fraction of two BigIntegers, the denominator is always positive. Reducing to lowest terms costs a
+    // gcd, so unless the policy is EAGER it waits until the terms grow and equal values may be stored with
+    // different terms. Comparisons cross multiply and never reduce.
+    class BigRational {
+    protected:
+        BigInteger num = 0;
+        BigInteger den = 1;
+        bool reduced = true; // known to be in lowest terms
+
+        inline static BigRational fromTerms(BigInteger numerator, BigInteger denominator, bool isReduced) {
+            BigRational result;
+            if (numerator.isZero()) return result;
+            if (denominator.isNegative) {
+                numerator.isNegative = !numerator.isNegative;
+                denominator.isNegative = false;
+            }
+            result.num = std::move(numerator);
+            result.den = std::move(denominator);
+            result.reduced = isReduced || result.den == 1;
+            return result.applyPolicy();
+        }
+
+        inline BigRational& applyPolicy() {
+            if (reduced || policy == ReducePolicy::ON_DEMAND) return *this;
+            if (policy == ReducePolicy::EAGER) return reduce();
+            if (std::max(num.number.size(), den.number.size()) > reduceThreshold) reduce();
+            return *this;
+        }
+
+        // -1, 0 or 1
+        inline int sign() const { return num.isZero() ? 0 : num.isNegative ? -1 : 1; }
+
+    public:
+        inline static ReducePolicy policy = ReducePolicy::THRESHOLD;
+        // number of 9 digit blocks a term may reach before the THRESHOLD policy reduces
+        inline static size_t reduceThreshold = 16;
+
+        inline BigRational() {}
+        inline BigRational(const BigInteger& value) : num(value) {}
+        // template for integer types
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline BigRational(T val) : num(val) {}
+        inline BigRational(const BigInteger& numerator, const BigInteger& denominator) {
+            if (denominator.isZero()) throw std::invalid_argument("Denominator cannot be zero");
+            *this = fromTerms(numerator, denominator, false);
+        }
+        // exact, coefficient / 10^scale
+        inline BigRational(const BigDecimal& value)
+            : BigRational(value.parent, BigInteger::powerOfTen(value.index)) {}
+        // "numerator/denominator" or anything BigDecimal parses
+        inline BigRational(const std::string& str) {
+            size_t slash = str.find('/');
+            if (slash == std::string::npos) *this = BigRational(BigDecimal(str));
+            else
+                *this = BigRational(BigInteger(str.substr(0, slash)), BigInteger(str.substr(slash + 1)));
+        }
+        inline BigRational(const char* str) : BigRational(std::string(str)) {}
+
+        // divides both terms by their gcd
+        inline BigRational& reduce() {
+            if (reduced) return *this;
+            BigInteger divisor = BigInteger::gcd(num, den);
+            if (!(divisor == 1)) {
+                num /= divisor;
+                den /= divisor;
+            }
+            reduced = true;
+            return *this;
+        }
+
+        inline bool isReduced() const { return reduced; }
+
+        // the terms as stored, in lowest terms only after reduce()
+        inline const BigInteger& numerator() const { return num; }
+        inline const BigInteger& denominator() const { return den; }
+
+        //Operations
+        inline BigRational operator-() const {
+            BigRational result = *this;
+            result.num.isNegative = !num.isNegative && !num.isZero();
+            return result;
+        }
+
+        inline BigRational operator+(const BigRational& right) const {
+            if (den == right.den) return fromTerms(num + right.num, den, false);
+            return fromTerms(num * right.den + right.num * den, den * right.den, false);
+        }
+
+        inline BigRational& operator+=(const BigRational& right) { return (*this) = (*this) + right; }
+
+        inline BigRational operator-(const BigRational& right) const { return *this + (-right); }
+
+        inline BigRational& operator-=(const BigRational& right) { return (*this) = (*this) - right; }
+
+        // of operands in lowest terms only a and d or c and b in a / b * c / d can share factors, with the
+        // EAGER policy these are divided out first and the product needs no further reduction
+        inline BigRational operator*(const BigRational& right) const {
+            if (policy == ReducePolicy::EAGER && reduced && right.reduced) {
+                BigInteger first = BigInteger::gcd(num, right.den), second = BigInteger::gcd(right.num, den);
+                return fromTerms((num / first) * (right.num / second), (den / second) * (right.den / first), true);
+            }
+            return fromTerms(num * right.num, den * right.den, false);
+        }
+
+        inline BigRational& operator*=(const BigRational& right) { return (*this) = (*this) * right; }
+
+        inline BigRational operator/(const BigRational& right) const {
+            if (right.num.isZero()) throw std::invalid_argument("Cannot divide by zero");
+            if (policy == ReducePolicy::EAGER && reduced && right.reduced) {
+                BigInteger first = BigInteger::gcd(num, right.num), second = BigInteger::gcd(den, right.den);
+                return fromTerms((num / first) * (right.den / second), (den / second) * (right.num / first), true);
+            }
+            return fromTerms(num * right.den, den * right.num, false);
+        }
+
+        inline BigRational& operator/=(const BigRational& right) { return (*this) = (*this) / right; }
+
+        // -1, 0 or 1. The signs decide first, then the digit counts of a * d and c * b when they are far
+        // enough apart, and only then the cross products are formed
+        inline int compare(const BigRational& right) const {
+            int leftSign = sign(), rightSign = right.sign();
+            if (leftSign != rightSign) return leftSign < rightSign ? -1 : 1;
+            if (leftSign == 0) return 0;
+            if (den == right.den) return num < right.num ? -1 : num > right.num ? 1 : 0;
+
+            // a p digit times a q digit number has p + q - 1 or p + q digits
+            size_t leftDigits = num.getNumDigits() + right.den.getNumDigits();
+            size_t rightDigits = right.num.getNumDigits() + den.getNumDigits();
+            if (leftDigits > rightDigits + 1) return leftSign;
+            if (rightDigits > leftDigits + 1) return -leftSign;
+
+            BigInteger left = num * right.den, crossed = right.num * den;
+            return left < crossed ? -1 : left > crossed ? 1 : 0;
+        }
+
+        inline bool operator==(const BigRational& right) const {
+            if (reduced && right.reduced) return num == right.num && den == right.den;
+            return compare(right) == 0;
+        }
+        inline bool operator!=(const BigRational& right) const { return !(*this == right); }
+        inline bool operator<(const BigRational& right) const { return compare(right) < 0; }
+        inline bool operator>(const BigRational& right) const { return compare(right) > 0; }
+        inline bool operator<=(const BigRational& right) const { return compare(right) <= 0; }
+        inline bool operator>=(const BigRational& right) const { return compare(right) >= 0; }
+
+        // rounded to mc.precision significant digits
+        inline BigDecimal toBigDecimal(const MathContext& mc) const {
+            return BigDecimal(num, 0).divide(BigDecimal(den, 0), mc);
+        }
+
+        // rounded to exactly scale digits after the point: one more digit is computed and the remainder of the
+        // division only decides ties. The quotient keeps the sign of num even when it truncates to zero, so
+        // directed modes round small negative values the right way (roundDigits clears a zero's sign)
+        inline BigDecimal toBigDecimal(size_t scale, RoundingMode mode = RoundingMode::HALF_EVEN) const {
+            BigInteger scaled = num * BigInteger::powerOfTen(scale + 1);
+            auto qr = scaled.unsignedDivide(scaled, den);
+            qr.first.isNegative = num.isNegative;
+            BigDecimal result(qr.first, scale + 1);
+            result.roundDigits(1, mode, !qr.second.isZero());
+            return result;
+        }
+
+        inline friend std::ostream& operator<<(std::ostream& out, const BigRational& right) {
+            return out << right.toString();
+        }
+
+        // "numerator/denominator" in lowest terms, just the numerator for integers
+        inline std::string toString() const {
+            BigRational r = *this;
+            r.reduce();
+            if (r.den == 1) return r.num.toString();
+            return r.num.toString() + "/" + r.den.toString();
+        }
+
+        inline size_t hash() const {
+            BigRational r = *this;
+            r.reduce();
+            size_t result = r.num.hash();
+            return result ^ (r.den.hash() + 0x9e3779b97f4a7c15ULL + (result << 6) + (result >> 2));
+        }
+    };
+
+    typedef BigRational BigRat;
+} // namespace estd
+
+template <>
+struct std::hash<estd::BigRational> {
+    inline size_t operator()(const estd::BigRational& val) const { return val.hash(); }
+};
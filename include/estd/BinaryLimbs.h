@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// kernels shared by the binary (base 2^64) integer types, numbers are little endian arrays of 64 bit limbs
+namespace estd {
+    namespace binlimbs {
+        typedef unsigned __int128 uint128_t;
+
+        inline constexpr int countLeadingZeros(uint64_t x) {
+            if (x == 0) return 64;
+            int result = 0;
+            for (uint64_t bit = uint64_t(1) << 63; (x & bit) == 0; bit >>= 1) result++;
+            return result;
+        }
+
+        // number of limbs ignoring the leading zero limbs
+        inline constexpr size_t significantLimbs(const uint64_t* x, size_t n) {
+            while (n > 0 && x[n - 1] == 0) n--;
+            return n;
+        }
+
+        inline constexpr size_t bitLength(const uint64_t* x, size_t n) {
+            n = significantLimbs(x, n);
+            if (n == 0) return 0;
+            return n * 64 - countLeadingZeros(x[n - 1]);
+        }
+
+        // x /= d in place, returns the remainder
+        inline constexpr uint64_t divideSmall(uint64_t* x, size_t n, uint64_t d) {
+            uint128_t remainder = 0;
+            for (size_t i = n; i-- > 0;) {
+                uint128_t current = (remainder << 64) | x[i];
+                x[i] = uint64_t(current / d);
+                remainder = current % d;
+            }
+            return uint64_t(remainder);
+        }
+
+        // x = x * m + a in place, returns the carry out of the top limb
+        inline constexpr uint64_t multiplyAddSmall(uint64_t* x, size_t n, uint64_t m, uint64_t a) {
+            uint128_t carry = a;
+            for (size_t i = 0; i < n; i++) {
+                carry += uint128_t(x[i]) * m;
+                x[i] = uint64_t(carry);
+                carry >>= 64;
+            }
+            return uint64_t(carry);
+        }
+
+        // schoolbook long division (Knuth's algorithm D), u has m limbs, v has n significant limbs (m >= n >= 1)
+        // q receives m - n + 1 limbs and r receives n limbs, scratch must hold m + n + 1 limbs.
+        inline constexpr void divide(
+            const uint64_t* u, size_t m, const uint64_t* v, size_t n, uint64_t* q, uint64_t* r, uint64_t* scratch
+        ) {
+            if (n == 1) {
+                uint128_t remainder = 0;
+                for (size_t i = m; i-- > 0;) {
+                    uint128_t current = (remainder << 64) | u[i];
+                    q[i] = uint64_t(current / v[0]);
+                    remainder = current % v[0];
+                }
+                r[0] = uint64_t(remainder);
+                return;
+            }
+
+            // normalize so the top bit of the divisor is set
+            int shift = countLeadingZeros(v[n - 1]);
+            uint64_t* un = scratch;
+            uint64_t* vn = scratch + m + 1;
+            for (size_t i = n - 1; i > 0; i--) {
+                vn[i] = (v[i] << shift) | (shift ? v[i - 1] >> (64 - shift) : 0);
+            }
+            vn[0] = v[0] << shift;
+            un[m] = shift ? u[m - 1] >> (64 - shift) : 0;
+            for (size_t i = m - 1; i > 0; i--) {
+                un[i] = (u[i] << shift) | (shift ? u[i - 1] >> (64 - shift) : 0);
+            }
+            un[0] = u[0] << shift;
+
+            for (size_t j = m - n + 1; j-- > 0;) {
+                uint128_t numerator = (uint128_t(un[j + n]) << 64) | un[j + n - 1];
+                uint128_t qhat = numerator / vn[n - 1];
+                uint128_t rhat = numerator % vn[n - 1];
+                while ((qhat >> 64) != 0 || qhat * vn[n - 2] > ((rhat << 64) | un[j + n - 2])) {
+                    qhat--;
+                    rhat += vn[n - 1];
+                    if ((rhat >> 64) != 0) break;
+                }
+
+                // un[j .. j+n] -= qhat * vn
+                uint64_t borrow = 0;
+                uint64_t carry = 0;
+                for (size_t i = 0; i < n; i++) {
+                    uint128_t product = qhat * vn[i] + carry;
+                    carry = uint64_t(product >> 64);
+                    uint64_t low = uint64_t(product);
+                    uint64_t before = un[i + j];
+                    uint64_t diff = before - low - borrow;
+                    borrow = (before < low) || (before - low < borrow);
+                    un[i + j] = diff;
+                }
+                uint64_t before = un[j + n];
+                un[j + n] = before - carry - borrow;
+                bool negative = (before < carry) || (before - carry < borrow);
+
+                if (negative) { // estimate was one too large, add the divisor back
+                    qhat--;
+                    uint128_t sum = 0;
+                    for (size_t i = 0; i < n; i++) {
+                        sum += uint128_t(un[i + j]) + vn[i];
+                        un[i + j] = uint64_t(sum);
+                        sum >>= 64;
+                    }
+                    un[j + n] += uint64_t(sum);
+                }
+                q[j] = uint64_t(qhat);
+            }
+
+            for (size_t i = 0; i < n - 1; i++) r[i] = (un[i] >> shift) | (shift ? un[i + 1] << (64 - shift) : 0);
+            r[n - 1] = un[n - 1] >> shift;
+        }
+    } // namespace binlimbs
+} // namespace estd
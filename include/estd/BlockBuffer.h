@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+namespace estd {
+    // Contiguous double ended buffer of base 1000000000 blocks. The first few blocks live inside the object
+    // (enough for any 64 bit value), so small numbers never touch the heap. Both push_front and push_back are
+    // amortized O(1) because the data is kept with free room on both sides.
+    // Larger buffers come from the memory resource that was current on the constructing thread (see
+    // ScopedBlockResource), or from malloc when there is none. Like the pmr containers a buffer keeps its
+    // resource for life: assignment never adopts the other side's resource, and move construction does.
+    // Heap storage is reference counted and copied on write: copies of a buffer share its blocks until one
+    // of them asks for a mutable reference, so copying a large value costs O(1). Pointers obtained from the
+    // non-const accessors are only valid until the buffer is copied.
+    class BlockBuffer {
+    public:
+        static constexpr size_t inlineBlocks = 4;
+
+        typedef uint32_t value_type;
+        typedef uint32_t* iterator;
+        typedef const uint32_t* const_iterator;
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        // the resource new buffers on this thread allocate from, nullptr for malloc / free
+        inline static std::pmr::memory_resource*& currentResource() {
+            thread_local std::pmr::memory_resource* current = nullptr;
+            return current;
+        }
+
+    protected:
+        std::pmr::memory_resource* resource = currentResource();
+        uint32_t* storage = local;
+        size_t head = inlineBlocks / 2;
+        size_t count = 0;
+        size_t capacity = inlineBlocks;
+        uint32_t local[inlineBlocks];
+
+        // heap storage starts with the number of buffers sharing it
+        struct Shared {
+            std::atomic<size_t> references;
+        };
+
+        inline bool isLocal() const { return storage == local; }
+        inline Shared* shared() const { return reinterpret_cast<Shared*>(storage) - 1; }
+        inline static size_t bytesFor(size_t n) { return sizeof(Shared) + n * sizeof(uint32_t); }
+
+        // n blocks of heap storage owned by this buffer alone
+        inline uint32_t* allocate(size_t n) {
+            void* memory = resource ? resource->allocate(bytesFor(n), alignof(Shared)) : std::malloc(bytesFor(n));
+            if (memory == nullptr) throw std::bad_alloc();
+            return reinterpret_cast<uint32_t*>(new (memory) Shared{{1}} + 1);
+        }
+
+        // drops this buffer's reference to the heap storage (if any), the last one frees it
+        inline void release() {
+            if (isLocal() || shared()->references.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+            if (resource) resource->deallocate(shared(), bytesFor(capacity), alignof(Shared));
+            else
+                std::free(shared());
+        }
+
+        // the storage is about to be written, take a private copy if it is shared
+        inline void mutate() {
+            if (!isShared()) return;
+            uint32_t* fresh = allocate(capacity);
+            if (count != 0) std::memcpy(fresh + head, storage + head, count * sizeof(uint32_t));
+            release();
+            storage = fresh;
+        }
+
+        inline void share(const BlockBuffer& other) {
+            other.shared()->references.fetch_add(1, std::memory_order_relaxed);
+            release();
+            storage = other.storage;
+            head = other.head;
+            count = other.count;
+            capacity = other.capacity;
+        }
+
+        // move the data into a buffer of newCapacity blocks with frontRoom free blocks before it
+        inline void relocate(size_t newCapacity, size_t frontRoom) {
+            if (newCapacity == capacity) {
+                std::memmove(storage + frontRoom, storage + head, count * sizeof(uint32_t));
+                head = frontRoom;
+                return;
+            }
+            uint32_t* fresh = allocate(newCapacity);
+            if (count != 0) std::memcpy(fresh + frontRoom, storage + head, count * sizeof(uint32_t));
+            release();
+            storage = fresh;
+            capacity = newCapacity;
+            head = frontRoom;
+        }
+
+        // make sure there is room for extra blocks in front (atFront) or behind the data
+        inline void makeRoom(size_t extra, bool atFront) {
+            size_t free = capacity - count;
+            if (free >= extra && (isLocal() || count * 2 < capacity)) {
+                // plenty of room overall, just recenter (cheap for the inline buffer, amortized otherwise)
+                size_t frontRoom = atFront ? free - (free - extra) / 2 : (free - extra) / 2;
+                relocate(capacity, frontRoom);
+                return;
+            }
+            size_t newCapacity = std::max(capacity * 2, count + extra + inlineBlocks);
+            free = newCapacity - count;
+            relocate(newCapacity, atFront ? free - (free - extra) / 2 : (free - extra) / 2);
+        }
+
+        // count = n blocks of private storage, the contents are left to the caller
+        inline void reserveFor(size_t n) {
+            if (n > capacity || isShared()) {
+                uint32_t* fresh = n > inlineBlocks ? allocate(n) : local;
+                release();
+                storage = fresh;
+                capacity = std::max(n, inlineBlocks);
+            }
+            head = (capacity - n) / 2;
+            count = n;
+        }
+
+    public:
+        inline BlockBuffer() {}
+        inline BlockBuffer(size_t n, uint32_t value) {
+            reserveFor(n);
+            std::fill(begin(), end(), value);
+        }
+        template <class It, typename std::enable_if<!std::is_integral<It>::value>::type* = nullptr>
+        inline BlockBuffer(It first, It last) {
+            reserveFor(std::distance(first, last));
+            std::copy(first, last, begin());
+        }
+        inline BlockBuffer(const BlockBuffer& other) { *this = other; }
+        // a copy drawing from memory instead of the current resource, it shares the blocks of other if it can
+        inline BlockBuffer(const BlockBuffer& other, std::pmr::memory_resource* memory) : resource(memory) {
+            *this = other;
+        }
+        inline BlockBuffer(BlockBuffer&& other) noexcept : resource(other.resource) { *this = std::move(other); }
+        inline ~BlockBuffer() { release(); }
+
+        inline BlockBuffer& operator=(const BlockBuffer& other) {
+            if (this == &other) return *this;
+            if (!other.isLocal() && other.resource == resource) {
+                share(other);
+                return *this;
+            }
+            reserveFor(other.count);
+            if (count != 0) std::memcpy(begin(), other.begin(), count * sizeof(uint32_t));
+            return *this;
+        }
+
+        inline BlockBuffer& operator=(BlockBuffer&& other) noexcept {
+            if (this == &other) return *this;
+            if (other.isLocal() || other.resource != resource) {
+                // the inline buffer cannot be stolen, and storage from another resource must not be adopted,
+                // copy into our own storage instead
+                if (other.count > capacity) reserveFor(other.count);
+                head = (capacity - other.count) / 2;
+                count = other.count;
+                if (count != 0) std::memcpy(begin(), other.begin(), count * sizeof(uint32_t));
+            } else {
+                release();
+                storage = other.storage;
+                head = other.head;
+                count = other.count;
+                capacity = other.capacity;
+                other.storage = other.local;
+                other.capacity = inlineBlocks;
+            }
+            other.head = other.capacity / 2;
+            other.count = 0;
+            return *this;
+        }
+
+
+        // the resource the heap storage comes from, nullptr for malloc / free
+        inline std::pmr::memory_resource* memoryResource() const { return resource; }
+
+        inline size_t size() const { return count; }
+        inline bool empty() const { return count == 0; }
+
+        inline uint32_t& operator[](size_t i) {
+            mutate();
+            return storage[head + i];
+        }
+        inline const uint32_t& operator[](size_t i) const { return storage[head + i]; }
+        inline uint32_t& front() {
+            mutate();
+            return storage[head];
+        }
+        inline const uint32_t& front() const { return storage[head]; }
+        inline uint32_t& back() {
+            mutate();
+            return storage[head + count - 1];
+        }
+        inline const uint32_t& back() const { return storage[head + count - 1]; }
+
+        inline iterator begin() {
+            mutate();
+            return storage + head;
+        }
+        inline iterator end() {
+            mutate();
+            return storage + head + count;
+        }
+        inline const_iterator begin() const { return storage + head; }
+        inline const_iterator end() const { return storage + head + count; }
+        inline reverse_iterator rbegin() { return reverse_iterator(end()); }
+        inline reverse_iterator rend() { return reverse_iterator(begin()); }
+        inline const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        inline const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        // whether the blocks are currently shared with a copy
+        inline bool isShared() const {
+            return !isLocal() && shared()->references.load(std::memory_order_acquire) != 1;
+        }
+
+        inline void push_front(uint32_t value) {
+            mutate();
+            if (head == 0) makeRoom(1, true);
+            storage[--head] = value;
+            count++;
+        }
+
+        inline void push_back(uint32_t value) {
+            mutate();
+            if (head + count == capacity) makeRoom(1, false);
+            storage[head + count++] = value;
+        }
+
+        // popping and clearing only move the bounds of this buffer, shared blocks stay untouched
+        inline void pop_front() {
+            head++;
+            count--;
+        }
+
+        inline void pop_back() { count--; }
+
+        inline void clear() {
+            head = capacity / 2;
+            count = 0;
+        }
+
+        // insert n copies of value before pos
+        inline iterator insert(const_iterator pos, size_t n, uint32_t value) {
+            size_t index = pos - storage - head;
+            mutate();
+            if (head + count + n > capacity) makeRoom(n, false);
+            uint32_t* at = begin() + index;
+            std::memmove(at + n, at, (count - index) * sizeof(uint32_t));
+            std::fill(at, at + n, value);
+            count += n;
+            return at;
+        }
+    };
+
+    // Makes resource the allocator of every BigInteger / BigDecimal created on this thread until the guard is
+    // destroyed (nullptr selects malloc / free). Values keep the resource they were created with, so values
+    // created in the scope must not outlive the resource, assign them to values created outside to keep them.
+    class ScopedBlockResource {
+    protected:
+        std::pmr::memory_resource* previous;
+
+    public:
+        inline explicit ScopedBlockResource(std::pmr::memory_resource* resource)
+            : previous(BlockBuffer::currentResource()) {
+            BlockBuffer::currentResource() = resource;
+        }
+        inline ~ScopedBlockResource() { BlockBuffer::currentResource() = previous; }
+
+        ScopedBlockResource(const ScopedBlockResource&) = delete;
+        ScopedBlockResource& operator=(const ScopedBlockResource&) = delete;
+    };
+
+    // Bump allocator for one computation on this thread: the temporaries draw from it and are released in
+    // bulk when the arena is destroyed, e.g. one arena per request instead of one free per temporary.
+    class BlockArena : public std::pmr::monotonic_buffer_resource {
+    protected:
+        ScopedBlockResource scope;
+
+    public:
+        inline explicit BlockArena(size_t initialSize = 64 * 1024,
+                                   std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+            : std::pmr::monotonic_buffer_resource(initialSize, upstream), scope(this) {}
+    };
+} // namespace estd
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// constexpr kernels on base 1000000000 blocks stored most significant block first (the BigInteger layout),
+// shared by the runtime algorithms and the compile time literals
+namespace estd {
+    namespace decimalblocks {
+        constexpr uint32_t base = 1000000000;
+
+        constexpr uint32_t powersOfTen[10] = {
+            1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+        };
+
+        // -1, 0 or 1, both sides without leading zero blocks
+        inline constexpr int compare(const uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+            if (na != nb) return na < nb ? -1 : 1;
+            for (size_t i = 0; i < na; i++) {
+                if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+            }
+            return 0;
+        }
+
+        // out = a + b, out has max(na, nb) + 1 blocks
+        inline constexpr void add(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+            size_t n = na > nb ? na : nb;
+            uint32_t carry = 0;
+            for (size_t i = 0; i < n; i++) {
+                uint32_t sum = carry + (i < na ? a[na - 1 - i] : 0) + (i < nb ? b[nb - 1 - i] : 0);
+                carry = sum >= base;
+                out[n - i] = carry ? sum - base : sum;
+            }
+            out[0] = carry;
+        }
+
+        // out = a * b (schoolbook), out has na + nb blocks
+        inline constexpr void multiply(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+            for (size_t i = 0; i < na + nb; i++) out[i] = 0;
+            for (size_t i = na; i-- > 0;) {
+                uint64_t carry = 0;
+                for (size_t j = nb; j-- > 0;) {
+                    uint64_t current = out[i + j + 1] + uint64_t(a[i]) * b[j] + carry;
+                    out[i + j + 1] = uint32_t(current % base);
+                    carry = current / base;
+                }
+                out[i] = uint32_t(carry);
+            }
+        }
+
+        // x = x * m + a in place (m, a < base), returns the carry out of the top block
+        inline constexpr uint32_t multiplyAddSmall(uint32_t* x, size_t n, uint32_t m, uint32_t a) {
+            uint64_t carry = a;
+            for (size_t i = n; i-- > 0;) {
+                carry += uint64_t(x[i]) * m;
+                x[i] = uint32_t(carry % base);
+                carry /= base;
+            }
+            return uint32_t(carry);
+        }
+
+        // a numeric literal split into base 1000000000 blocks, value = blocks * 10^exponent
+        template <size_t N>
+        struct Literal {
+            uint32_t blocks[N] = {};
+            size_t offset = 0; // leading zero blocks
+            int64_t exponent = 0;
+            bool isInteger = true;
+            bool isValid = true;
+        };
+
+        inline constexpr uint32_t literalBase(const char* str, size_t length) {
+            if (length > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) return 16;
+            if (length > 2 && str[0] == '0' && (str[1] == 'b' || str[1] == 'B')) return 2;
+            if (length > 1 && str[0] == '0') {
+                for (size_t i = 1; i < length; i++) {
+                    if (str[i] == '.' || str[i] == 'e' || str[i] == 'E') return 10;
+                }
+                return 8;
+            }
+            return 10;
+        }
+
+        // enough blocks for every digit of the literal
+        inline constexpr size_t literalBlocks(const char* str, size_t length) {
+            uint32_t b = literalBase(str, length);
+            if (b == 10) return length / 9 + 1;
+            return length * (b == 16 ? 4 : b == 8 ? 3 : 1) / 29 + 1; // 2^29 < base
+        }
+
+        inline constexpr uint32_t digitValue(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return 16;
+        }
+
+        // parses the characters of an integer or floating point literal: digit separators are skipped,
+        // 0x, 0b and 0 (octal) prefixes follow the C++ rules, decimal literals may have a point and an exponent
+        template <size_t N>
+        inline constexpr Literal<N> parseLiteral(const char* str, size_t length) {
+            Literal<N> result;
+            uint32_t b = literalBase(str, length);
+            size_t i = (b == 16 || b == 2) ? 2 : 0;
+            bool fraction = false;
+            for (; i < length; i++) {
+                char c = str[i];
+                if (c == '\'') continue;
+                if (b == 10 && c == '.' && !fraction) {
+                    fraction = true;
+                    result.isInteger = false;
+                    continue;
+                }
+                if (b == 10 && (c == 'e' || c == 'E')) break;
+                uint32_t digit = digitValue(c);
+                if (digit >= b) {
+                    result.isValid = false;
+                    return result;
+                }
+                if (multiplyAddSmall(result.blocks, N, b, digit) != 0) result.isValid = false;
+                if (fraction) result.exponent--;
+            }
+            if (i < length) { // exponent part
+                result.isInteger = false;
+                bool negative = false;
+                int64_t exponent = 0;
+                for (i++; i < length; i++) {
+                    if (str[i] == '-') negative = true;
+                    else if (str[i] >= '0' && str[i] <= '9')
+                        exponent = exponent * 10 + (str[i] - '0');
+                    else if (str[i] != '+' && str[i] != '\'')
+                        result.isValid = false;
+                }
+                result.exponent += negative ? -exponent : exponent;
+            }
+            while (result.offset + 1 < N && result.blocks[result.offset] == 0) result.offset++;
+            return result;
+        }
+    } // namespace decimalblocks
+} // namespace estd
@@ -0,0 +1,370 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <estd/DecimalBlocks.h>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(ESTD_NO_SIMD)
+#define ESTD_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define ESTD_X86_KERNELS 0
+#endif
+
+#if defined(__SIZEOF_INT128__) && !defined(ESTD_NO_WIDE_LIMBS)
+#define ESTD_WIDE_LIMBS 1
+#else
+#define ESTD_WIDE_LIMBS 0
+#endif
+
+// runtime kernels on base 1000000000 blocks (most significant block first). The scalar versions are always
+// available, on x86 AVX2 and AVX-512 versions are compiled with target attributes and the best one the cpu
+// supports is picked on first use. With 128 bit integers (unless ESTD_NO_WIDE_LIMBS is defined) longer
+// products pack the blocks into base 10^18 limbs, a quarter of the multiplications of the 10^9 kernels.
+namespace estd {
+    namespace decimalblocks {
+        struct Kernels {
+            const char* name;
+            // out = a + b, out has max(na, nb) + 1 blocks
+            void (*add)(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out);
+            // out = a * b, out has na + nb blocks
+            void (*multiply)(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out);
+            // -1, 0 or 1, both sides without leading zero blocks
+            int (*compare)(const uint32_t* a, size_t na, const uint32_t* b, size_t nb);
+            // x = 999999999 - x for every block
+            void (*ninesComplement)(uint32_t* x, size_t n);
+        };
+
+        // 64 bit column sums of the schoolbook product, they can take this many rows before they need a carry
+        // pass: 18 * (base - 1)^2 + base < 2^64
+        constexpr size_t deferredRows = 16;
+
+        inline uint64_t* columnScratch(size_t n) {
+            thread_local std::vector<uint64_t> scratch;
+            scratch.assign(n, 0);
+            return scratch.data();
+        }
+
+        inline void normalizeColumns(uint64_t* columns, size_t n) {
+            uint64_t carry = 0;
+            for (size_t k = n; k-- > 0;) {
+                uint64_t value = columns[k] + carry;
+                columns[k] = value % base;
+                carry = value / base;
+            }
+        }
+
+        inline void storeColumns(uint64_t* columns, size_t n, uint32_t* out) {
+            normalizeColumns(columns, n);
+            for (size_t k = 0; k < n; k++) out[k] = uint32_t(columns[k]);
+        }
+
+        inline void multiplyScalar(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+            uint64_t* columns = columnScratch(na + nb);
+            for (size_t i = 0; i < na; i++) {
+                uint64_t* row = columns + i + 1;
+                for (size_t j = 0; j < nb; j++) row[j] += uint64_t(a[i]) * b[j];
+                if (i % deferredRows == deferredRows - 1) normalizeColumns(columns, na + nb);
+            }
+            storeColumns(columns, na + nb, out);
+        }
+
+#if ESTD_WIDE_LIMBS
+        typedef unsigned __int128 uint128_t;
+
+        constexpr uint64_t wideBase = uint64_t(base) * base;
+
+        // 128 bit column sums of 10^18 limbs, after a carry pass: 256 * (wideBase - 1)^2 + wideBase < 2^128
+        constexpr size_t wideDeferredRows = 256;
+
+        // value / wideBase, the remainder is stored in remainder
+        inline uint128_t divideWide(uint128_t value, uint64_t& remainder) {
+            uint64_t high = uint64_t(value >> 64);
+            uint64_t low = uint64_t(value);
+            if (high == 0) {
+                remainder = low % wideBase;
+                return low / wideBase;
+            }
+#if defined(__x86_64__) && defined(__GNUC__)
+            // one hardware 128 / 64 division instead of the generic 128 bit one
+            uint64_t quotient;
+            __asm__("divq %4" : "=a"(quotient), "=d"(remainder) : "a"(low), "d"(high % wideBase), "rm"(wideBase));
+            return uint128_t(high / wideBase) << 64 | quotient;
+#else
+            remainder = uint64_t(value % wideBase);
+            return value / wideBase;
+#endif
+        }
+
+        // pairs of blocks as 10^18 limbs, least significant first, returns the number of limbs
+        inline size_t packWide(const uint32_t* x, size_t n, uint64_t* limbs) {
+            size_t count = (n + 1) / 2;
+            for (size_t k = 0; k < count; k++) {
+                size_t low = n - 1 - 2 * k;
+                limbs[k] = (low >= 1 ? uint64_t(x[low - 1]) * base : 0) + x[low];
+            }
+            return count;
+        }
+
+        inline void normalizeWide(uint128_t* columns, size_t n) {
+            uint128_t carry = 0;
+            for (size_t k = 0; k < n; k++) {
+                uint64_t remainder;
+                carry = divideWide(columns[k] + carry, remainder);
+                columns[k] = remainder;
+            }
+        }
+
+        // out = a * b in 10^18 limbs with deferred carries, out has na + nb blocks
+        inline void multiplyWide(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+            thread_local std::vector<uint64_t> limbs;
+            thread_local std::vector<uint128_t> columns;
+            limbs.resize((na + 1) / 2 + (nb + 1) / 2);
+            size_t la = packWide(a, na, limbs.data());
+            size_t lb = packWide(b, nb, limbs.data() + la);
+            const uint64_t* wa = limbs.data();
+            const uint64_t* wb = limbs.data() + la;
+            columns.assign(la + lb, 0);
+            for (size_t i = 0; i < la; i++) {
+                uint128_t* row = columns.data() + i;
+                uint64_t x = wa[i];
+                for (size_t j = 0; j < lb; j++) row[j] += uint128_t(x) * wb[j];
+                if (i % wideDeferredRows == wideDeferredRows - 1) normalizeWide(columns.data(), la + lb);
+            }
+            normalizeWide(columns.data(), la + lb);
+            // the limbs may hold one or two more (zero) blocks than out
+            size_t n = na + nb;
+            for (size_t k = 0; k < n; k++) {
+                uint64_t limb = uint64_t(columns[k / 2]);
+                out[n - 1 - k] = uint32_t(k % 2 ? limb / base : limb % base);
+            }
+        }
+#endif
+
+        // shorter products than this stay in 10^9 blocks, packing them costs more than it saves
+        constexpr size_t wideMinBlocks = 24;
+
+        // the wide multiply for long operands, narrow otherwise. the rows run over the shorter operand, every
+        // carry pass covers the whole product so they would make a long outer loop quadratic in its length
+        template <void (*narrow)(const uint32_t*, size_t, const uint32_t*, size_t, uint32_t*)>
+        inline void multiplyBest(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+            if (na > nb) return multiplyBest<narrow>(b, nb, a, na, out);
+#if ESTD_WIDE_LIMBS
+            if (na >= wideMinBlocks && nb >= wideMinBlocks) return multiplyWide(a, na, b, nb, out);
+#endif
+            narrow(a, na, b, nb, out);
+        }
+
+        inline void ninesComplementScalar(uint32_t* x, size_t n) {
+            for (size_t i = 0; i < n; i++) x[i] = base - 1 - x[i];
+        }
+
+        // carries through the part of the sum the vector loops did not cover, positions [0, end) of the result
+        inline void addTail(
+            const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out, size_t end, uint32_t carry
+        ) {
+            size_t n = na > nb ? na : nb;
+            for (size_t k = end; k-- > 0;) {
+                uint32_t sum = carry;
+                if (k >= n - na) sum += a[k - (n - na)];
+                if (k >= n - nb) sum += b[k - (n - nb)];
+                carry = sum >= base;
+                out[k + 1] = carry ? sum - base : sum;
+            }
+            out[0] = carry;
+        }
+
+        inline const Kernels& scalarKernels() {
+            static const Kernels kernels = {
+                "scalar", add, multiplyBest<multiplyScalar>, compare, ninesComplementScalar
+            };
+            return kernels;
+        }
+
+#if ESTD_X86_KERNELS
+        __attribute__((target("avx2"))) inline void
+        multiplyAvx2(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+            uint64_t* columns = columnScratch(na + nb);
+            for (size_t i = 0; i < na; i++) {
+                uint64_t* row = columns + i + 1;
+                __m256i ai = _mm256_set1_epi64x(a[i]);
+                size_t j = 0;
+                for (; j + 4 <= nb; j += 4) {
+                    __m256i bj = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(b + j)));
+                    __m256i sum = _mm256_add_epi64(_mm256_loadu_si256((__m256i*)(row + j)), _mm256_mul_epu32(ai, bj));
+                    _mm256_storeu_si256((__m256i*)(row + j), sum);
+                }
+                for (; j < nb; j++) row[j] += uint64_t(a[i]) * b[j];
+                if (i % deferredRows == deferredRows - 1) normalizeColumns(columns, na + nb);
+            }
+            storeColumns(columns, na + nb, out);
+        }
+
+        // 8 blocks per step from the least significant end, the carry of every lane moves one lane up with a
+        // permute. a lane that becomes exactly base again (999999999 plus a carry) is redone with scalar code.
+        __attribute__((target("avx2"))) inline void
+        addAvx2(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+            size_t n = na > nb ? na : nb;
+            size_t overlap = na < nb ? na : nb;
+            const __m256i vBase = _mm256_set1_epi32(base);
+            const __m256i vMax = _mm256_set1_epi32(base - 1);
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i up = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+            uint32_t carry = 0;
+            size_t k = n;
+            for (; k >= n - overlap + 8; k -= 8) {
+                __m256i va = _mm256_loadu_si256((const __m256i*)(a + k - 8 - (n - na)));
+                __m256i vb = _mm256_loadu_si256((const __m256i*)(b + k - 8 - (n - nb)));
+                __m256i sum = _mm256_add_epi32(va, vb);
+                __m256i overflow = _mm256_cmpgt_epi32(sum, vMax);
+                sum = _mm256_sub_epi32(sum, _mm256_and_si256(overflow, vBase));
+                __m256i carries = _mm256_and_si256(overflow, one);
+                __m256i incoming = _mm256_permutevar8x32_epi32(carries, up);
+                incoming = _mm256_blend_epi32(incoming, _mm256_set1_epi32(carry), 0x80);
+                sum = _mm256_add_epi32(sum, incoming);
+                if (!_mm256_testz_si256(_mm256_cmpeq_epi32(sum, vBase), _mm256_cmpeq_epi32(sum, vBase))) {
+                    for (size_t l = k; l-- > k - 8;) {
+                        uint32_t value = a[l - (n - na)] + b[l - (n - nb)] + carry;
+                        carry = value >= base;
+                        out[l + 1] = carry ? value - base : value;
+                    }
+                    continue;
+                }
+                _mm256_storeu_si256((__m256i*)(out + k - 7), sum);
+                carry = _mm256_extract_epi32(carries, 0);
+            }
+            addTail(a, na, b, nb, out, k, carry);
+        }
+
+        __attribute__((target("avx2"))) inline int
+        compareAvx2(const uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+            if (na != nb) return na < nb ? -1 : 1;
+            size_t i = 0;
+            for (; i + 8 <= na; i += 8) {
+                __m256i equal = _mm256_cmpeq_epi32(
+                    _mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i))
+                );
+                uint32_t mask = _mm256_movemask_epi8(equal);
+                if (mask != 0xFFFFFFFF) {
+                    size_t lane = i + __builtin_ctz(~mask) / 4;
+                    return a[lane] < b[lane] ? -1 : 1;
+                }
+            }
+            for (; i < na; i++) {
+                if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+            }
+            return 0;
+        }
+
+        __attribute__((target("avx2"))) inline void ninesComplementAvx2(uint32_t* x, size_t n) {
+            const __m256i vMax = _mm256_set1_epi32(base - 1);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m256i value = _mm256_loadu_si256((__m256i*)(x + i));
+                _mm256_storeu_si256((__m256i*)(x + i), _mm256_sub_epi32(vMax, value));
+            }
+            for (; i < n; i++) x[i] = base - 1 - x[i];
+        }
+
+        __attribute__((target("avx512f"))) inline void
+        multiplyAvx512(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+            uint64_t* columns = columnScratch(na + nb);
+            for (size_t i = 0; i < na; i++) {
+                uint64_t* row = columns + i + 1;
+                __m512i ai = _mm512_set1_epi64(a[i]);
+                size_t j = 0;
+                for (; j + 8 <= nb; j += 8) {
+                    // the zero masked forms avoid gcc's maybe-uninitialized false positive on the plain ones
+                    __m512i bj = _mm512_maskz_cvtepu32_epi64(0xFF, _mm256_loadu_si256((const __m256i*)(b + j)));
+                    __m512i sum = _mm512_add_epi64(_mm512_loadu_si512(row + j), _mm512_maskz_mul_epu32(0xFF, ai, bj));
+                    _mm512_storeu_si512(row + j, sum);
+                }
+                for (; j < nb; j++) row[j] += uint64_t(a[i]) * b[j];
+                if (i % deferredRows == deferredRows - 1) normalizeColumns(columns, na + nb);
+            }
+            storeColumns(columns, na + nb, out);
+        }
+
+        // same scheme as addAvx2 with 16 lanes, the carries move up as a shifted lane mask
+        __attribute__((target("avx512f"))) inline void
+        addAvx512(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+            size_t n = na > nb ? na : nb;
+            size_t overlap = na < nb ? na : nb;
+            const __m512i vBase = _mm512_set1_epi32(base);
+            const __m512i one = _mm512_set1_epi32(1);
+            uint32_t carry = 0;
+            size_t k = n;
+            for (; k >= n - overlap + 16; k -= 16) {
+                __m512i va = _mm512_loadu_si512(a + k - 16 - (n - na));
+                __m512i vb = _mm512_loadu_si512(b + k - 16 - (n - nb));
+                __m512i sum = _mm512_add_epi32(va, vb);
+                __mmask16 overflow = _mm512_cmpge_epu32_mask(sum, vBase);
+                sum = _mm512_mask_sub_epi32(sum, overflow, sum, vBase);
+                __mmask16 incoming = __mmask16((overflow >> 1) | (carry << 15));
+                sum = _mm512_mask_add_epi32(sum, incoming, sum, one);
+                if (_mm512_cmpeq_epi32_mask(sum, vBase) != 0) {
+                    for (size_t l = k; l-- > k - 16;) {
+                        uint32_t value = a[l - (n - na)] + b[l - (n - nb)] + carry;
+                        carry = value >= base;
+                        out[l + 1] = carry ? value - base : value;
+                    }
+                    continue;
+                }
+                _mm512_storeu_si512(out + k - 15, sum);
+                carry = overflow & 1;
+            }
+            addTail(a, na, b, nb, out, k, carry);
+        }
+
+        __attribute__((target("avx512f"))) inline int
+        compareAvx512(const uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+            if (na != nb) return na < nb ? -1 : 1;
+            size_t i = 0;
+            for (; i + 16 <= na; i += 16) {
+                __mmask16 different = _mm512_cmpneq_epi32_mask(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+                if (different != 0) {
+                    size_t lane = i + __builtin_ctz(different);
+                    return a[lane] < b[lane] ? -1 : 1;
+                }
+            }
+            for (; i < na; i++) {
+                if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+            }
+            return 0;
+        }
+
+        inline const Kernels* avx2Kernels() {
+            static const Kernels kernels = {
+                "avx2", addAvx2, multiplyBest<multiplyAvx2>, compareAvx2, ninesComplementAvx2
+            };
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &kernels : nullptr;
+        }
+
+        inline const Kernels* avx512Kernels() {
+            static const Kernels kernels = {
+                "avx512", addAvx512, multiplyBest<multiplyAvx512>, compareAvx512, ninesComplementAvx2
+            };
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") ? &kernels : nullptr;
+        }
+#endif
+
+        // every kernel set this cpu can run, the scalar one first
+        inline std::vector<const Kernels*> availableKernels() {
+            std::vector<const Kernels*> result = {&scalarKernels()};
+#if ESTD_X86_KERNELS
+            if (avx2Kernels()) result.push_back(avx2Kernels());
+            if (avx512Kernels()) result.push_back(avx512Kernels());
+#endif
+            return result;
+        }
+
+        // the fastest kernel set, selected once
+        inline const Kernels& kernels() {
+            static const Kernels& selected = *availableKernels().back();
+            return selected;
+        }
+    } // namespace decimalblocks
+} // namespace estd
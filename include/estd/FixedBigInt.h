@@ -0,0 +1,337 @@
+#pragma once
+
+#include <array>
+#include <estd/BigInteger.h>
+#include <estd/BinaryLimbs.h>
+#include <exception>
+#include <string>
+#include <utility>
+
+namespace estd {
+    // Unsigned integer of exactly Bits bits with inline storage (no allocation), for crypto and hashing work
+    // where the size is known ahead of time. Arithmetic wraps modulo 2^Bits like the built-in unsigned
+    // types, the *Overflow functions report when that happened. Converting a negative BigInteger gives
+    // its two's complement. Everything except the string conversions is constexpr.
+    template <size_t Bits>
+    class FixedBigInt {
+        static_assert(Bits % 64 == 0 && Bits >= 64, "FixedBigInt needs a whole number of 64 bit limbs");
+
+    public:
+        static constexpr size_t limbCount = Bits / 64;
+
+    protected:
+        template <size_t OtherBits>
+        friend class FixedBigInt;
+
+        typedef binlimbs::uint128_t uint128_t;
+
+        std::array<uint64_t, limbCount> limbs{}; // little endian
+
+        // calls f(0), f(1) ... f(limbCount - 1) without a loop
+        template <class F, size_t... I>
+        inline static constexpr void unrollImpl(F&& f, std::index_sequence<I...>) {
+            (f(I), ...);
+        }
+        template <class F>
+        inline static constexpr void unroll(F&& f) {
+            unrollImpl(f, std::make_index_sequence<limbCount>{});
+        }
+
+        // returns the carry out of the top limb
+        inline static constexpr bool addTo(FixedBigInt& left, const FixedBigInt& right) {
+            uint64_t carry = 0;
+            unroll([&](size_t i) {
+                uint128_t sum = uint128_t(left.limbs[i]) + right.limbs[i] + carry;
+                left.limbs[i] = uint64_t(sum);
+                carry = uint64_t(sum >> 64);
+            });
+            return carry != 0;
+        }
+
+        // returns the borrow out of the top limb
+        inline static constexpr bool subtractFrom(FixedBigInt& left, const FixedBigInt& right) {
+            uint64_t borrow = 0;
+            unroll([&](size_t i) {
+                uint64_t before = left.limbs[i];
+                left.limbs[i] = before - right.limbs[i] - borrow;
+                borrow = (before < right.limbs[i]) || (before - right.limbs[i] < borrow);
+            });
+            return borrow != 0;
+        }
+
+        // full product, the low half and whether the high half is nonzero
+        inline static constexpr FixedBigInt
+        multiplyLow(const FixedBigInt& left, const FixedBigInt& right, bool& overflow) {
+            FixedBigInt result;
+            overflow = false;
+            for (size_t i = 0; i < limbCount; i++) {
+                if (left.limbs[i] == 0) continue;
+                uint64_t carry = 0;
+                unroll([&](size_t j) {
+                    if (i + j < limbCount) {
+                        uint128_t product = uint128_t(left.limbs[i]) * right.limbs[j] + result.limbs[i + j] + carry;
+                        result.limbs[i + j] = uint64_t(product);
+                        carry = uint64_t(product >> 64);
+                    } else if (right.limbs[j] != 0) {
+                        overflow = true;
+                    }
+                });
+                if (carry != 0) overflow = true;
+            }
+            return result;
+        }
+
+        inline static constexpr std::pair<FixedBigInt, FixedBigInt>
+        divide(const FixedBigInt& left, const FixedBigInt& right) {
+            size_t m = binlimbs::significantLimbs(left.limbs.data(), limbCount);
+            size_t n = binlimbs::significantLimbs(right.limbs.data(), limbCount);
+            if (n == 0) throw std::invalid_argument("Cannot divide by zero");
+            if (left < right) return {FixedBigInt(), left};
+
+            FixedBigInt quotient, remainder;
+            std::array<uint64_t, 2 * limbCount + 1> scratch{};
+            uint64_t* q = quotient.limbs.data();
+            uint64_t* r = remainder.limbs.data();
+            binlimbs::divide(left.limbs.data(), m, right.limbs.data(), n, q, r, scratch.data());
+            return {quotient, remainder};
+        }
+
+    public:
+        //Constructors
+        inline constexpr FixedBigInt() {}
+        inline FixedBigInt(std::string val) : FixedBigInt(BigInteger(val)) {}
+        inline FixedBigInt(const char* val) : FixedBigInt(BigInteger(val)) {}
+        inline explicit FixedBigInt(const BigInteger& val) {
+            // horner's rule over the base 10^9 blocks
+            for (auto token : val.number) binlimbs::multiplyAddSmall(limbs.data(), limbCount, 1000000000, token);
+            if (val.isNegative) *this = -*this;
+        }
+        // template for integer types, negative values wrap
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline constexpr FixedBigInt(T val) {
+            limbs[0] = uint64_t(val);
+            if constexpr (std::is_signed<T>::value) {
+                if (val < 0) {
+                    for (size_t i = 1; i < limbCount; i++) limbs[i] = ~uint64_t(0);
+                }
+            }
+        }
+        // truncating or zero extending conversion between widths
+        template <size_t OtherBits>
+        inline constexpr explicit FixedBigInt(const FixedBigInt<OtherBits>& val) {
+            for (size_t i = 0; i < limbCount && i < FixedBigInt<OtherBits>::limbCount; i++) limbs[i] = val.limbs[i];
+        }
+
+        inline BigInteger toBigInteger() const {
+            BigInteger result = nullptr;
+            FixedBigInt tmp = *this;
+            size_t n = binlimbs::significantLimbs(tmp.limbs.data(), limbCount);
+            while (n > 0) {
+                result.number.push_front(binlimbs::divideSmall(tmp.limbs.data(), n, 1000000000));
+                n = binlimbs::significantLimbs(tmp.limbs.data(), n);
+            }
+            if (result.number.size() == 0) result.number.push_front(0);
+            return result;
+        }
+
+        inline explicit operator BigInteger() const { return toBigInteger(); }
+
+        inline constexpr uint64_t toUint() const { return limbs[0]; }
+        inline constexpr uint64_t getLimb(size_t i) const { return limbs[i]; }
+        inline constexpr void setLimb(size_t i, uint64_t value) { limbs[i] = value; }
+
+        //Checked operations, like the __builtin_*_overflow functions: result is the wrapped value and the
+        //return value tells if it differs from the exact one
+        inline static constexpr bool
+        addOverflow(const FixedBigInt& left, const FixedBigInt& right, FixedBigInt& result) {
+            result = left;
+            return addTo(result, right);
+        }
+        inline static constexpr bool
+        subOverflow(const FixedBigInt& left, const FixedBigInt& right, FixedBigInt& result) {
+            result = left;
+            return subtractFrom(result, right);
+        }
+        inline static constexpr bool
+        mulOverflow(const FixedBigInt& left, const FixedBigInt& right, FixedBigInt& result) {
+            bool overflow = false;
+            result = multiplyLow(left, right, overflow);
+            return overflow;
+        }
+
+        // exact product, twice as wide
+        inline constexpr FixedBigInt<2 * Bits> multiplyFull(const FixedBigInt& right) const {
+            FixedBigInt<2 * Bits> result;
+            for (size_t i = 0; i < limbCount; i++) {
+                uint64_t carry = 0;
+                unroll([&](size_t j) {
+                    uint128_t product = uint128_t(limbs[i]) * right.limbs[j] + result.limbs[i + j] + carry;
+                    result.limbs[i + j] = uint64_t(product);
+                    carry = uint64_t(product >> 64);
+                });
+                result.limbs[i + limbCount] = carry;
+            }
+            return result;
+        }
+
+        //Operations (modulo 2^Bits)
+        inline constexpr FixedBigInt operator+(const FixedBigInt& right) const {
+            FixedBigInt result = *this;
+            addTo(result, right);
+            return result;
+        }
+        inline constexpr FixedBigInt& operator+=(const FixedBigInt& right) {
+            addTo(*this, right);
+            return *this;
+        }
+
+        inline constexpr FixedBigInt operator-(const FixedBigInt& right) const {
+            FixedBigInt result = *this;
+            subtractFrom(result, right);
+            return result;
+        }
+        inline constexpr FixedBigInt& operator-=(const FixedBigInt& right) {
+            subtractFrom(*this, right);
+            return *this;
+        }
+        inline constexpr FixedBigInt operator-() const { return FixedBigInt() - *this; }
+
+        inline constexpr FixedBigInt operator*(const FixedBigInt& right) const {
+            bool overflow = false;
+            return multiplyLow(*this, right, overflow);
+        }
+        inline constexpr FixedBigInt& operator*=(const FixedBigInt& right) { return (*this) = (*this) * right; }
+
+        inline constexpr FixedBigInt operator/(const FixedBigInt& right) const { return divide(*this, right).first; }
+        inline constexpr FixedBigInt& operator/=(const FixedBigInt& right) { return (*this) = (*this) / right; }
+
+        inline constexpr FixedBigInt operator%(const FixedBigInt& right) const { return divide(*this, right).second; }
+        inline constexpr FixedBigInt& operator%=(const FixedBigInt& right) { return (*this) = (*this) % right; }
+
+        inline constexpr FixedBigInt power(FixedBigInt p) const {
+            FixedBigInt result = 1;
+            FixedBigInt base = *this;
+            for (size_t bits = bitLength(p); bits > 0; bits--) {
+                if (p.limbs[0] & 1) result *= base;
+                base *= base;
+                p >>= 1;
+            }
+            return result;
+        }
+
+        // (this ^ p) % m, the products are carried out at twice the width so nothing wraps
+        inline constexpr FixedBigInt powerMod(const FixedBigInt& p, const FixedBigInt& m) const {
+            FixedBigInt<2 * Bits> wideM(m);
+            FixedBigInt result = FixedBigInt(1) % m;
+            FixedBigInt base = *this % m;
+            for (size_t i = 0, bits = bitLength(p); i < bits; i++) {
+                if (p.testBit(i)) result = FixedBigInt(result.multiplyFull(base) % wideM);
+                base = FixedBigInt(base.multiplyFull(base) % wideM);
+            }
+            return result;
+        }
+
+        inline constexpr FixedBigInt operator++(int) {
+            FixedBigInt oldThis = *this;
+            *this += 1;
+            return oldThis;
+        };
+        inline constexpr FixedBigInt& operator++() { return *this += 1; };
+        inline constexpr FixedBigInt operator--(int) {
+            FixedBigInt oldThis = *this;
+            *this -= 1;
+            return oldThis;
+        };
+        inline constexpr FixedBigInt& operator--() { return *this -= 1; };
+
+        //Bitwise operations
+        inline constexpr FixedBigInt operator&(const FixedBigInt& right) const {
+            FixedBigInt result;
+            unroll([&](size_t i) { result.limbs[i] = limbs[i] & right.limbs[i]; });
+            return result;
+        }
+        inline constexpr FixedBigInt operator|(const FixedBigInt& right) const {
+            FixedBigInt result;
+            unroll([&](size_t i) { result.limbs[i] = limbs[i] | right.limbs[i]; });
+            return result;
+        }
+        inline constexpr FixedBigInt operator^(const FixedBigInt& right) const {
+            FixedBigInt result;
+            unroll([&](size_t i) { result.limbs[i] = limbs[i] ^ right.limbs[i]; });
+            return result;
+        }
+        inline constexpr FixedBigInt operator~() const {
+            FixedBigInt result;
+            unroll([&](size_t i) { result.limbs[i] = ~limbs[i]; });
+            return result;
+        }
+        inline constexpr FixedBigInt& operator&=(const FixedBigInt& right) { return (*this) = (*this) & right; }
+        inline constexpr FixedBigInt& operator|=(const FixedBigInt& right) { return (*this) = (*this) | right; }
+        inline constexpr FixedBigInt& operator^=(const FixedBigInt& right) { return (*this) = (*this) ^ right; }
+
+        inline constexpr FixedBigInt operator<<(size_t shift) const {
+            FixedBigInt result;
+            if (shift >= Bits) return result;
+            size_t limbShift = shift / 64;
+            unsigned bitShift = shift % 64;
+            for (size_t i = limbCount; i-- > limbShift;) {
+                result.limbs[i] = limbs[i - limbShift] << bitShift;
+                if (bitShift != 0 && i > limbShift) result.limbs[i] |= limbs[i - limbShift - 1] >> (64 - bitShift);
+            }
+            return result;
+        }
+
+        inline constexpr FixedBigInt operator>>(size_t shift) const {
+            FixedBigInt result;
+            if (shift >= Bits) return result;
+            size_t limbShift = shift / 64;
+            unsigned bitShift = shift % 64;
+            for (size_t i = 0; i + limbShift < limbCount; i++) {
+                result.limbs[i] = limbs[i + limbShift] >> bitShift;
+                if (bitShift != 0 && i + limbShift + 1 < limbCount) {
+                    result.limbs[i] |= limbs[i + limbShift + 1] << (64 - bitShift);
+                }
+            }
+            return result;
+        }
+
+        inline constexpr FixedBigInt& operator<<=(size_t shift) { return (*this) = (*this) << shift; }
+        inline constexpr FixedBigInt& operator>>=(size_t shift) { return (*this) = (*this) >> shift; }
+
+        inline constexpr bool testBit(size_t bit) const { return bit < Bits && (limbs[bit / 64] >> (bit % 64)) & 1; }
+        inline constexpr static size_t bitLength(const FixedBigInt& x) {
+            return binlimbs::bitLength(x.limbs.data(), limbCount);
+        }
+        inline constexpr size_t bitLength() const { return bitLength(*this); }
+
+        //Comparators
+        inline constexpr bool operator==(const FixedBigInt& right) const {
+            uint64_t difference = 0;
+            unroll([&](size_t i) { difference |= limbs[i] ^ right.limbs[i]; });
+            return difference == 0;
+        }
+        inline constexpr bool operator!=(const FixedBigInt& right) const { return !(operator==(right)); }
+
+        inline constexpr bool operator<(const FixedBigInt& right) const {
+            // the borrow of the subtraction is the comparison result, no early exit
+            FixedBigInt tmp = *this;
+            return subtractFrom(tmp, right);
+        }
+        inline constexpr bool operator>(const FixedBigInt& right) const { return right < *this; }
+        inline constexpr bool operator<=(const FixedBigInt& right) const { return !(right < *this); }
+        inline constexpr bool operator>=(const FixedBigInt& right) const { return !(*this < right); }
+
+        inline friend std::ostream& operator<<(std::ostream& out, const FixedBigInt& right) {
+            return out << right.toString();
+        }
+
+        inline std::string toString() const { return toBigInteger().toString(); }
+    };
+
+    typedef FixedBigInt<128> UInt128;
+    typedef FixedBigInt<256> UInt256;
+    typedef FixedBigInt<512> UInt512;
+    typedef FixedBigInt<1024> UInt1024;
+    typedef FixedBigInt<2048> UInt2048;
+    typedef FixedBigInt<4096> UInt4096;
+} // namespace estd
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <cstdint>
+#include <estd/BigDecimal.h>
+#include <estd/BigInteger.h>
+#include <exception>
+#include <string>
+
+namespace estd {
+    // Decimal with a fixed number of digits after the point (money and the like). The value is stored
+    // scaled by 10^Scale in an inline 128 bit integer, arithmetic uses the overflow checking builtins and
+    // only falls back to a heap allocated BigInteger once a result does not fit anymore (and back again
+    // once it does). sizeof(FixedDecimal) == 16 either way.
+    template <size_t Scale>
+    class FixedDecimal {
+        static_assert(Scale <= 36, "FixedDecimal scale must leave room in 128 bits");
+
+    protected:
+        // a promoted value has this tag in the high word and the BigInteger pointer in the low word,
+        // inline values with this high word count as overflow
+        static constexpr uint64_t promotedTag = uint64_t(1) << 63;
+
+        __int128 raw = 0;
+
+        inline static constexpr __int128 scaleFactor() {
+            __int128 result = 1;
+            for (size_t i = 0; i < Scale; i++) result *= 10;
+            return result;
+        }
+
+        inline static bool fitsInline(__int128 v) { return uint64_t((unsigned __int128)v >> 64) != promotedTag; }
+        inline bool isInline() const { return fitsInline(raw); }
+        inline BigInteger* big() const { return reinterpret_cast<BigInteger*>(uintptr_t(uint64_t(raw))); }
+
+        inline void release() {
+            if (!isInline()) delete big();
+            raw = 0;
+        }
+
+        inline static BigInteger toBigInteger(__int128 v) {
+            unsigned __int128 magnitude = v < 0 ? -(unsigned __int128)v : (unsigned __int128)v;
+            BigInteger result = nullptr;
+            while (magnitude != 0) {
+                result.number.push_front(uint32_t(magnitude % 1000000000));
+                magnitude /= 1000000000;
+            }
+            if (result.number.size() == 0) result.number.push_front(0);
+            result.isNegative = v < 0;
+            return result;
+        }
+
+        inline static bool fromBigInteger(const BigInteger& v, __int128& out) {
+            if (v.number.size() > 5) return false;
+            unsigned __int128 magnitude = 0;
+            for (auto token : v.number) {
+                if (__builtin_mul_overflow(magnitude, (unsigned __int128)1000000000, &magnitude)) return false;
+                if (__builtin_add_overflow(magnitude, (unsigned __int128)token, &magnitude)) return false;
+            }
+            unsigned __int128 limit = (unsigned __int128)1 << 127;
+            if (magnitude > limit || (magnitude == limit && !v.isNegative)) return false;
+            out = v.isNegative ? (__int128)(-magnitude) : (__int128)magnitude;
+            return fitsInline(out);
+        }
+
+        // the value times 10^Scale
+        inline BigInteger scaled() const { return isInline() ? toBigInteger(raw) : *big(); }
+
+        inline FixedDecimal& assignScaled(const BigInteger& v) {
+            __int128 value;
+            if (fromBigInteger(v, value)) {
+                release();
+                raw = value;
+            } else if (isInline()) {
+                raw = (__int128)(((unsigned __int128)promotedTag << 64) | uintptr_t(new BigInteger(v)));
+            } else {
+                *big() = v;
+            }
+            return *this;
+        }
+
+        // round(numerator / denominator) with ties to even, for the 128 bit fast path
+        inline static __int128 roundedQuotient(__int128 numerator, __int128 denominator) {
+            __int128 q = numerator / denominator;
+            __int128 r = numerator % denominator;
+            if (r < 0) r = -r;
+            __int128 d = denominator < 0 ? -denominator : denominator;
+            if (r > d - r || (r == d - r && q % 2 != 0)) q += ((numerator < 0) != (denominator < 0)) ? -1 : 1;
+            return q;
+        }
+
+        inline static BigInteger roundedQuotient(const BigInteger& numerator, const BigInteger& denominator) {
+            auto qr = numerator.unsignedDivide(numerator, denominator);
+            BigInteger twice = qr.second.unsignedAdd(qr.second, qr.second);
+            bool odd = qr.first.number[qr.first.number.size() - 1] % 2 == 1;
+            // the divisor may be negative, compare magnitudes like the 128 bit overload
+            bool above = numerator.isMagnitudeLessThan(denominator, twice);
+            if (above || (odd && numerator.isMagnitudeEqual(twice, denominator))) {
+                qr.first = qr.first.unsignedAdd(qr.first, 1);
+            }
+            qr.first.isNegative = numerator.isNegative != denominator.isNegative && !qr.first.isZero();
+            return qr.first;
+        }
+
+    public:
+        inline FixedDecimal() {}
+        inline FixedDecimal(const FixedDecimal& other) {
+            if (other.isInline()) raw = other.raw;
+            else
+                assignScaled(*other.big());
+        }
+        inline FixedDecimal(FixedDecimal&& other) noexcept {
+            raw = other.raw;
+            other.raw = 0;
+        }
+        // lossless, throws if val has more than Scale digits after the point (see rounded())
+        inline FixedDecimal(const BigDecimal& val) { this->operator=(val); }
+        inline FixedDecimal(std::string val) { this->operator=(BigDecimal(val)); }
+        inline FixedDecimal(const char* val) { this->operator=(BigDecimal(val)); }
+        // template for integer types
+        template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+        inline FixedDecimal(T val) {
+            __int128 value = val;
+            if (__builtin_mul_overflow(value, scaleFactor(), &raw) || !fitsInline(raw)) {
+                raw = 0;
+                assignScaled(BigInteger(val) * toBigInteger(scaleFactor()));
+            }
+        }
+        inline ~FixedDecimal() { release(); }
+
+        inline static FixedDecimal rounded(BigDecimal val, RoundingMode mode = RoundingMode::HALF_EVEN) {
+            FixedDecimal result;
+            val.setScale(Scale, mode);
+            result.assignScaled(val.parent);
+            return result;
+        }
+
+        inline FixedDecimal& operator=(const FixedDecimal& other) {
+            if (this == &other) return *this;
+            if (other.isInline()) {
+                release();
+                raw = other.raw;
+                return *this;
+            }
+            return assignScaled(*other.big());
+        }
+
+        inline FixedDecimal& operator=(FixedDecimal&& other) noexcept {
+            if (this == &other) return *this;
+            release();
+            raw = other.raw;
+            other.raw = 0;
+            return *this;
+        }
+
+        inline FixedDecimal& operator=(BigDecimal val) {
+            val.normalize();
+            if (val.index > Scale) throw std::invalid_argument("Value has more decimals than the FixedDecimal scale");
+            val.setScale(Scale);
+            return assignScaled(val.parent);
+        }
+
+        // true once the value left the 128 bit range and lives on the heap
+        inline bool isPromoted() const { return !isInline(); }
+
+        //Operations
+        inline FixedDecimal operator-() const {
+            FixedDecimal result;
+            if (isInline() && !__builtin_sub_overflow(__int128(0), raw, &result.raw) && fitsInline(result.raw)) {
+                return result;
+            }
+            result.raw = 0;
+            BigInteger value = scaled();
+            value.isNegative = !value.isNegative && !value.isZero();
+            return result.assignScaled(value);
+        }
+
+        inline FixedDecimal operator+(const FixedDecimal& right) const {
+            FixedDecimal result;
+            if (isInline() && right.isInline() && !__builtin_add_overflow(raw, right.raw, &result.raw) &&
+                fitsInline(result.raw)) {
+                return result;
+            }
+            result.raw = 0;
+            return result.assignScaled(scaled() + right.scaled());
+        }
+
+        inline FixedDecimal& operator+=(const FixedDecimal& right) { return (*this) = (*this) + right; }
+
+        inline FixedDecimal operator-(const FixedDecimal& right) const {
+            FixedDecimal result;
+            if (isInline() && right.isInline() && !__builtin_sub_overflow(raw, right.raw, &result.raw) &&
+                fitsInline(result.raw)) {
+                return result;
+            }
+            result.raw = 0;
+            return result.assignScaled(scaled() - right.scaled());
+        }
+
+        inline FixedDecimal& operator-=(const FixedDecimal& right) { return (*this) = (*this) - right; }
+
+        // the exact product has 2 * Scale decimals, it is rounded half to even back to Scale
+        inline FixedDecimal operator*(const FixedDecimal& right) const {
+            FixedDecimal result;
+            __int128 product;
+            if (isInline() && right.isInline() && !__builtin_mul_overflow(raw, right.raw, &product)) {
+                result.raw = roundedQuotient(product, scaleFactor());
+                if (fitsInline(result.raw)) return result;
+                result.raw = 0;
+            }
+            return result.assignScaled(roundedQuotient(scaled() * right.scaled(), toBigInteger(scaleFactor())));
+        }
+
+        inline FixedDecimal& operator*=(const FixedDecimal& right) { return (*this) = (*this) * right; }
+
+        // rounded half to even to Scale decimals
+        inline FixedDecimal operator/(const FixedDecimal& right) const {
+            if (right.isInline() && right.raw == 0) throw std::invalid_argument("Cannot divide by zero");
+            FixedDecimal result;
+            __int128 numerator;
+            if (isInline() && right.isInline() && !__builtin_mul_overflow(raw, scaleFactor(), &numerator)) {
+                result.raw = roundedQuotient(numerator, right.raw);
+                if (fitsInline(result.raw)) return result;
+                result.raw = 0;
+            }
+            return result.assignScaled(roundedQuotient(scaled() * toBigInteger(scaleFactor()), right.scaled()));
+        }
+
+        inline FixedDecimal& operator/=(const FixedDecimal& right) { return (*this) = (*this) / right; }
+
+        //Comparators
+        inline bool operator==(const FixedDecimal& right) const {
+            if (isInline() && right.isInline()) return raw == right.raw;
+            return scaled() == right.scaled();
+        }
+
+        inline bool operator!=(const FixedDecimal& right) const { return !(operator==(right)); }
+
+        inline bool operator<(const FixedDecimal& right) const {
+            if (isInline() && right.isInline()) return raw < right.raw;
+            return scaled() < right.scaled();
+        }
+
+        inline bool operator>(const FixedDecimal& right) const { return right < *this; }
+        inline bool operator<=(const FixedDecimal& right) const { return !(right < *this); }
+        inline bool operator>=(const FixedDecimal& right) const { return !(*this < right); }
+
+        inline friend std::ostream& operator<<(std::ostream& out, const FixedDecimal& right) {
+            return out << right.toString();
+        }
+
+        inline BigDecimal toBigDecimal() const {
+            BigDecimal result = nullptr;
+            result.parent = scaled();
+            result.index = Scale;
+            return result;
+        }
+
+        inline explicit operator BigDecimal() const { return toBigDecimal(); }
+
+        // always prints Scale digits after the point
+        inline std::string toString() const {
+            if (!isInline()) {
+                std::string str = big()->toString();
+                bool negative = str[0] == '-';
+                if (negative) str = str.substr(1);
+                if (str.length() <= Scale) str = std::string(Scale - str.length() + 1, '0') + str;
+                if (Scale != 0) str.insert(str.length() - Scale, ".");
+                return negative ? "-" + str : str;
+            }
+
+            unsigned __int128 magnitude = raw < 0 ? -(unsigned __int128)raw : (unsigned __int128)raw;
+            std::string str;
+            for (size_t i = 0; i < Scale; i++) {
+                str += char('0' + magnitude % 10);
+                magnitude /= 10;
+            }
+            if (Scale != 0) str += '.';
+            do {
+                str += char('0' + magnitude % 10);
+                magnitude /= 10;
+            } while (magnitude != 0);
+            if (raw < 0) str += '-';
+            return std::string(str.rbegin(), str.rend());
+        }
+    };
+} // namespace estd
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <estd/DecimalKernels.h>
+#include <vector>
+
+// montgomery arithmetic on base 1000000000 blocks. For a modulus n coprime to 10 with k blocks and R = base^k a
+// residue x is kept as x * R mod n, a product is then reduced by adding the multiple of n that clears its low
+// block k times (no division), so every operation stays at the size of the modulus.
+namespace estd {
+    namespace decimalblocks {
+        class Montgomery {
+        public:
+            // little endian (least significant block first), always size() blocks, below the modulus
+            typedef std::vector<uint32_t> Residue;
+
+        protected:
+            Residue modulus;
+            uint64_t inverse; // -n^-1 mod base
+            mutable std::vector<uint64_t> scratch;
+
+            // little endian columns, the carry out of the last one is dropped (it is zero)
+            inline static void carryColumns(uint64_t* t, size_t n) {
+                uint64_t carry = 0;
+                for (size_t i = 0; i < n; i++) {
+                    uint64_t value = t[i] + carry;
+                    t[i] = value % base;
+                    carry = value / base;
+                }
+            }
+
+            // t (k blocks and a top block) is below 2n, subtracts n when t >= n
+            inline void reduceOnce(uint64_t* t, uint64_t top) const {
+                size_t k = modulus.size();
+                size_t i = k;
+                if (top == 0) {
+                    while (i > 0 && t[i - 1] == modulus[i - 1]) i--;
+                    if (i > 0 && t[i - 1] < modulus[i - 1]) return;
+                }
+                uint64_t borrow = 0;
+                for (i = 0; i < k; i++) {
+                    uint64_t subtrahend = modulus[i] + borrow;
+                    borrow = t[i] < subtrahend;
+                    t[i] = t[i] + (borrow ? base : 0) - subtrahend;
+                }
+            }
+
+        public:
+            // n most significant block first (the BigInteger layout), odd and not divisible by 5
+            inline Montgomery(const uint32_t* n, size_t count) : modulus(count), scratch(2 * count + 1) {
+                for (size_t i = 0; i < count; i++) modulus[i] = n[count - 1 - i];
+                // n * x = 1 (mod 10) for one of 1, 3, 7, 9, then hensel lifting doubles the digits per step
+                uint64_t low = modulus[0];
+                uint64_t x = 1;
+                while (low * x % 10 != 1) x += 2;
+                for (int step = 0; step < 4; step++) x = x * ((2 + base - low * x % base) % base) % base;
+                inverse = base - x;
+            }
+
+            inline size_t size() const { return modulus.size(); }
+            inline const Residue& getModulus() const { return modulus; }
+
+            // out = a * b / R mod n, out may be a or b. Row i adds a[i] * b and the multiple u * n that clears
+            // column i, so column i only passes its carry on. The columns take two products per row and are
+            // carried every deferredRows / 2 rows, like the schoolbook kernels.
+            inline void multiply(const Residue& a, const Residue& b, Residue& out) const {
+                size_t k = modulus.size();
+                uint64_t* t = scratch.data();
+                for (size_t i = 0; i < 2 * k + 1; i++) t[i] = 0;
+                const uint32_t* n = modulus.data();
+                for (size_t i = 0; i < k; i++) {
+                    uint64_t ai = a[i];
+                    uint64_t u = (t[i] + ai * b[0]) % base * inverse % base;
+                    uint64_t* row = t + i;
+                    for (size_t j = 0; j < k; j++) row[j] += ai * b[j] + u * n[j];
+                    t[i + 1] += t[i] / base;
+                    if (i % (deferredRows / 2) == deferredRows / 2 - 1) carryColumns(t + i + 1, 2 * k - i);
+                }
+                carryColumns(t + k, k + 1);
+                reduceOnce(t + k, t[2 * k]);
+                out.resize(k);
+                for (size_t i = 0; i < k; i++) out[i] = uint32_t(t[k + i]);
+            }
+
+            // out = a + b mod n, out may be a or b
+            inline void add(const Residue& a, const Residue& b, Residue& out) const {
+                size_t k = modulus.size();
+                uint64_t* t = scratch.data();
+                uint64_t carry = 0;
+                for (size_t i = 0; i < k; i++) {
+                    uint64_t value = uint64_t(a[i]) + b[i] + carry;
+                    carry = value >= base;
+                    t[i] = carry ? value - base : value;
+                }
+                reduceOnce(t, carry);
+                out.resize(k);
+                for (size_t i = 0; i < k; i++) out[i] = uint32_t(t[i]);
+            }
+
+            // out = a - b mod n, out may be a or b
+            inline void subtract(const Residue& a, const Residue& b, Residue& out) const {
+                size_t k = modulus.size();
+                out.resize(k);
+                uint32_t borrow = 0;
+                for (size_t i = 0; i < k; i++) {
+                    uint32_t subtrahend = b[i] + borrow;
+                    borrow = a[i] < subtrahend;
+                    out[i] = a[i] + (borrow ? base : 0) - subtrahend;
+                }
+                if (!borrow) return;
+                uint32_t carry = 0;
+                for (size_t i = 0; i < k; i++) {
+                    uint32_t value = out[i] + modulus[i] + carry;
+                    carry = value >= base;
+                    out[i] = carry ? value - base : value;
+                }
+            }
+
+            inline static bool isZero(const Residue& a) {
+                for (uint32_t block : a) {
+                    if (block != 0) return false;
+                }
+                return true;
+            }
+        };
+    } // namespace decimalblocks
+} // namespace estd
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <estd/BigInteger.h>
+#include <functional>
+#include <vector>
+
+namespace estd {
+    // Balanced product tree: level 0 holds the values, every next level the products of neighbouring pairs (an
+    // odd one out moves up unchanged) and the last one the product of all. Reducing a number down the tree
+    // gives its remainder modulo every value with divisions between operands of similar size (a remainder
+    // tree), combining residues up the tree reconstructs a number from them (chinese remainder theorem).
+    // Large levels are split over BigInteger's executor (BigInteger::setMultiplyThreads / setExecutor).
+    class ProductTree {
+    protected:
+        std::vector<std::vector<BigInteger>> levels;
+
+        inline static size_t blocksOf(const std::vector<BigInteger>& nodes) {
+            size_t blocks = 0;
+            for (const auto& node : nodes) blocks += node.number.size();
+            return blocks;
+        }
+
+        // f(0) ... f(n - 1), in parallel when an executor is set and the level is large
+        template <class F>
+        inline static std::vector<BigInteger> mapLevel(size_t n, size_t blocks, F&& f) {
+            bool parallel = BigInteger::executor && n > 1 && blocks >= BigInteger::parallelThreshold;
+            auto result = BigInteger::parallelResults<std::vector<BigInteger>>(parallel, n);
+            if (!parallel) {
+                for (size_t i = 0; i < n; i++) result[i] = f(i);
+                return result;
+            }
+            size_t chunks = std::min<size_t>(n, 256);
+            std::vector<std::function<void()>> tasks;
+            for (size_t c = 0; c < chunks; c++) {
+                tasks.push_back([&, c] {
+                    for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; i++) result[i] = f(i);
+                });
+            }
+            BigInteger::executor(tasks);
+            return result;
+        }
+
+        // |x| reduced down the tree given by levels, one remainder per leaf
+        inline static std::vector<BigInteger>
+        reduce(const BigInteger& x, const std::vector<std::vector<BigInteger>>& levels) {
+            std::vector<BigInteger> current = {x % levels.back()[0]};
+            for (size_t level = levels.size() - 1; level-- > 0;) {
+                const std::vector<BigInteger>& nodes = levels[level];
+                current = mapLevel(nodes.size(), blocksOf(nodes), [&](size_t i) { return current[i / 2] % nodes[i]; });
+            }
+            return current;
+        }
+
+    public:
+        inline explicit ProductTree(std::vector<BigInteger> values) {
+            levels.push_back(std::move(values));
+            while (levels.back().size() > 1) {
+                const std::vector<BigInteger>& below = levels.back();
+                levels.push_back(mapLevel((below.size() + 1) / 2, blocksOf(below), [&](size_t i) {
+                    return 2 * i + 1 < below.size() ? below[2 * i] * below[2 * i + 1] : below[2 * i];
+                }));
+            }
+        }
+
+        inline size_t size() const { return levels[0].size(); }
+
+        // the product of all values, 1 for none
+        inline BigInteger product() const { return size() == 0 ? BigInteger(1) : levels.back()[0]; }
+
+        inline const std::vector<std::vector<BigInteger>>& getLevels() const { return levels; }
+
+        // x mod every value in [0, value), the values must be non-zero
+        inline std::vector<BigInteger> remainders(const BigInteger& x) const {
+            if (size() == 0) return {};
+            std::vector<BigInteger> result = reduce(x, levels);
+            if (x.isNegative) {
+                for (size_t i = 0; i < result.size(); i++) {
+                    if (!result[i].isZero()) result[i] = result[i].unsignedSubtract(levels[0][i], result[i]);
+                }
+            }
+            return result;
+        }
+
+        // the x in [0, product()) with x = residues[i] (mod value i), the values must be pairwise coprime and
+        // positive. x is the sum of residues[i] * c_i^-1 * product() / value i, with c_i = product() / value i
+        // mod value i taken from a remainder tree over the squared nodes, the sum is formed up the tree.
+        inline BigInteger crt(const std::vector<BigInteger>& residues) const {
+            if (residues.size() != size()) throw std::invalid_argument("Need one residue per modulus");
+            if (size() == 0) return 0;
+
+            std::vector<std::vector<BigInteger>> squares;
+            for (const auto& nodes : levels) {
+                squares.push_back(mapLevel(nodes.size(), 2 * blocksOf(nodes), [&](size_t i) {
+                    return nodes[i] * nodes[i];
+                }));
+            }
+            const std::vector<BigInteger>& moduli = levels[0];
+            std::vector<BigInteger> cofactors = reduce(levels.back()[0], squares);
+            std::vector<BigInteger> current = mapLevel(size(), blocksOf(moduli), [&](size_t i) {
+                BigInteger inverse = (cofactors[i] / moduli[i]).modInverse(moduli[i]);
+                BigInteger residue = residues[i] % moduli[i];
+                if (residues[i].isNegative && !residue.isZero()) residue = moduli[i] - residue;
+                return residue * inverse % moduli[i];
+            });
+
+            // a node holds the sum over its leaves of s_i * (node product / value i)
+            for (size_t level = 1; level < levels.size(); level++) {
+                const std::vector<BigInteger>& below = levels[level - 1];
+                current = mapLevel(levels[level].size(), blocksOf(below), [&](size_t i) {
+                    if (2 * i + 1 == below.size()) return current[2 * i];
+                    return current[2 * i] * below[2 * i + 1] + current[2 * i + 1] * below[2 * i];
+                });
+            }
+            return current[0] % levels.back()[0];
+        }
+
+        // x mod every modulus in [0, modulus)
+        inline static std::vector<BigInteger> remainderTree(const BigInteger& x, std::vector<BigInteger> moduli) {
+            return ProductTree(std::move(moduli)).remainders(x);
+        }
+
+        // the x in [0, product of the moduli) with x = residues[i] (mod moduli[i]) for pairwise coprime moduli
+        inline static BigInteger crt(const std::vector<BigInteger>& residues, std::vector<BigInteger> moduli) {
+            return ProductTree(std::move(moduli)).crt(residues);
+        }
+    };
+} // namespace estd
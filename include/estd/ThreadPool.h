@@ -0,0 +1,97 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace estd {
+    // Small fixed size pool for fork/join work. A thread waiting for its tasks runs queued tasks in the
+    // meantime (newest first), so nested fork/join never deadlocks and no thread idles while work is queued.
+    class ThreadPool {
+    protected:
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<std::function<void()>> queue;
+        std::vector<std::thread> workers;
+        bool stopping = false;
+
+        // runs the newest queued task, the lock is released while it runs
+        inline bool runOne(std::unique_lock<std::mutex>& lock) {
+            if (queue.empty()) return false;
+            std::function<void()> task = std::move(queue.back());
+            queue.pop_back();
+            lock.unlock();
+            task();
+            lock.lock();
+            return true;
+        }
+
+        inline void work() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                changed.wait(lock, [&] { return stopping || !queue.empty(); });
+                if (stopping && queue.empty()) return;
+                runOne(lock);
+            }
+        }
+
+    public:
+        inline explicit ThreadPool(size_t threads) {
+            for (size_t i = 0; i < threads; i++) workers.emplace_back([this] { work(); });
+        }
+
+        inline ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            changed.notify_all();
+            for (auto& worker : workers) worker.join();
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        inline size_t size() const { return workers.size(); }
+
+        // runs every task, the calling thread takes part, returns once all of them finished. The first
+        // exception thrown by a task is rethrown here.
+        inline void run(const std::vector<std::function<void()>>& tasks) {
+            if (tasks.empty()) return;
+            size_t remaining = tasks.size() - 1;
+            std::exception_ptr error;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (size_t i = 1; i < tasks.size(); i++) {
+                    queue.push_back([&, i] {
+                        std::exception_ptr taskError;
+                        try {
+                            tasks[i]();
+                        } catch (...) { taskError = std::current_exception(); }
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (taskError && !error) error = taskError;
+                        remaining--;
+                        changed.notify_all();
+                    });
+                }
+            }
+            changed.notify_all();
+
+            std::exception_ptr ownError;
+            try {
+                tasks[0]();
+            } catch (...) { ownError = std::current_exception(); }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            while (remaining != 0) {
+                if (!runOne(lock)) changed.wait(lock, [&] { return remaining == 0 || !queue.empty(); });
+            }
+            if (ownError) std::rethrow_exception(ownError);
+            if (error) std::rethrow_exception(error);
+        }
+    };
+} // namespace estd
@@ -1,8 +1,20 @@
+#include <array>
 #include <climits>
+#include <estd/BigBinaryInteger.h>
 #include <estd/BigDecimal.h>
+#include <estd/BigDecimalAccumulator.h>
+#include <estd/BigDecimalArray.h>
+#include <estd/BigFloat.h>
 #include <estd/BigInteger.h>
+#include <estd/BigIntegerArray.h>
+#include <estd/BigRational.h>
+#include <estd/FixedBigInt.h>
+#include <estd/FixedDecimal.h>
+#include <estd/ProductTree.h>
 #include <estd/UnitTest.h>
 #include <iostream>
+#include <map>
+#include <sstream>
 #include <vector>
 
 
@@ -460,6 +472,789 @@ int main() {
         return sum.toString() == "0.001"; // Assuming up to 3 decimal places of precision
     });
 
+    // Small values use native arithmetic and promote to blocks on overflow
+
+    test.testBlock({
+        BigInt a = INT64_MAX;
+        BigInt b = a + 1;
+        BigInt c = b - 1;
+        return b.toString() == "9223372036854775808" && c == a &&
+               (b * b).toString() == "85070591730234615865843651857942052864";
+    });
+
+    test.testBlock({
+        BigInt a = INT64_MIN;
+        BigInt b = BigInt{"-100000000000000000000"} / 7;
+        return a.toString() == "-9223372036854775808" && a / -1 == BigInt{"9223372036854775808"} &&
+               b.toString() == "-14285714285714285714" && BigInt{-7} / 2 == -3 && BigInt{-7} % 2 == 1;
+    });
+
+    test.testBlock({
+        BigInt a = BigInt{"123456789012345678901234567890"};
+        return (a + 10).toString() == "123456789012345678901234567900" &&
+               (a - uint64_t(UINT64_MAX)).toString() == "123456788993898934827525016275" &&
+               (a * 1000000007).toString() == "123456789876543201987654320198641975230" && a % 26435 == 3215 &&
+               a / -1000 == BigInt{"-123456789012345678901234567"} && a > 0 && BigInt{0} - a < INT64_MIN;
+    });
+
+    // Literals, parsed at compile time
+
+    test.testBlock({
+        constexpr uint32_t a[] = {999999999, 999999999};
+        constexpr uint32_t b[] = {1};
+        constexpr auto sum = [&] {
+            std::array<uint32_t, 3> out{};
+            decimalblocks::add(a, 2, b, 1, out.data());
+            return out;
+        }();
+        static_assert(sum[0] == 1 && sum[1] == 0 && sum[2] == 0, "block kernels are usable in constant expressions");
+        return 123456789012345678901234567890_bi == BigInt{"123456789012345678901234567890"} &&
+               0xffffffffffffffffffffffffffffffff_bi == BigInt{2}.power(128) - 1 && 0b1010_bi == 10 &&
+               -1'000'000_bi == -1000000;
+    });
+
+    test.testBlock({
+        return (3.14159_bd).toString() == "3.14159" && 1.5e-20_bd == BigDec{"0.000000000000000000015"} &&
+               2.5e3_bd == 2500 && 0.1_bd + 0.2_bd == 0.3_bd;
+    });
+
+    // SIMD block kernels agree with the scalar ones
+
+    test.testBlock({
+        std::vector<uint32_t> a(67), b(45);
+        for (size_t i = 0; i < a.size(); i++) a[i] = i % 3 == 0 ? 999999999 : uint32_t(i * 123456789 % 1000000000);
+        for (size_t i = 0; i < b.size(); i++) b[i] = i % 5 == 0 ? 999999999 : uint32_t(i * 987654321 % 1000000000);
+        const auto& scalar = decimalblocks::scalarKernels();
+        std::vector<uint32_t> sum(68), product(112), nines = a;
+        scalar.add(a.data(), a.size(), b.data(), b.size(), sum.data());
+        scalar.multiply(a.data(), a.size(), b.data(), b.size(), product.data());
+        scalar.ninesComplement(nines.data(), nines.size());
+        for (auto kernels : decimalblocks::availableKernels()) {
+            std::vector<uint32_t> s(68), p(112), n = a;
+            kernels->add(a.data(), a.size(), b.data(), b.size(), s.data());
+            kernels->multiply(a.data(), a.size(), b.data(), b.size(), p.data());
+            kernels->ninesComplement(n.data(), n.size());
+            if (s != sum || p != product || n != nines) return false;
+            if (kernels->compare(a.data(), a.size(), a.data(), a.size()) != 0) return false;
+            if (kernels->compare(product.data(), 112, p.data() + 1, 111) != 1) return false;
+        }
+        return true;
+    });
+
+    // Parallel multiplication gives the same result as the serial one
+
+    test.testBlock({
+        BigInt a = BigInt{3}.power(30000);
+        BigInt b = BigInt{7}.power(25000);
+        BigInt serial = a * b;
+        size_t oldThreshold = BigInt::parallelThreshold;
+        BigInt::parallelThreshold = 200;
+        BigInt::setMultiplyThreads(4);
+        BigInt pooled = a * b;
+        size_t calls = 0;
+        BigInt::setExecutor([&](const std::vector<std::function<void()>>& tasks) {
+            calls++;
+            for (auto& task : tasks) task();
+        });
+        BigInt executed = a * b;
+        BigInt::setExecutor(nullptr);
+        BigInt::parallelThreshold = oldThreshold;
+        return pooled == serial && executed == serial && calls > 0;
+    });
+
+    // Columnar batch kernels
+
+    test.testBlock({
+        BigIntegerArray a = BigIntegerArray::parseAll({"123456789012345678901", "-5", "0", "999999999", "0x10"});
+        std::vector<std::string> scaled = a.mulScalar(-3).toStrings();
+        std::vector<int8_t> compared = a.compare(16);
+        return a.size() == 5 && a[0] == BigInt{"123456789012345678901"} &&
+               a.sum() == BigInt{"123456789013345678911"} && scaled[0] == "-370370367037037036703" &&
+               scaled[1] == "15" && scaled[2] == "0" && compared == std::vector<int8_t>{1, -1, -1, 1, 0};
+    });
+
+    test.testBlock({
+        BigDecimalArray a = BigDecimalArray::parseAll({"1.5", "-0.25", "3", "0.001"}, 3);
+        std::vector<std::string> strings = a.toStrings();
+        return strings[1] == "-0.250" && strings[2] == "3.000" && a.sum() == BigDec{"4.251"} &&
+               a[3] == BigDec{"0.001"} && a.compare(BigDec{"1.4999"}) == std::vector<int8_t>{1, -1, 1, -1};
+    });
+
+    // Pluggable block storage
+
+    test.testBlock({
+        struct Counting : std::pmr::memory_resource {
+            long live = 0, total = 0;
+            void* do_allocate(size_t bytes, size_t align) override {
+                live++, total++;
+                return std::pmr::new_delete_resource()->allocate(bytes, align);
+            }
+            void do_deallocate(void* p, size_t bytes, size_t align) override {
+                live--;
+                std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+            }
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+        } counting;
+        BigInt outside;
+        {
+            ScopedBlockResource scope(&counting);
+            BigInt a = BigInt{3}.power(2000);
+            outside = a * a + 1;
+        }
+        BigInt heap = outside * 2;
+        return counting.total > 0 && counting.live == 0 && outside == BigInt{9}.power(2000) + 1 &&
+               heap == outside + outside;
+    });
+
+    test.testBlock({
+        BigInt a = BigInt{7}.power(20000), b = BigInt{7}.power(4000);
+        BigInt expected = a * a, expectedUnbalanced = a * b, expectedFactorial = BigInt::factorial(3000);
+        BigInt result, unbalanced, factorial;
+        BigDec decimal;
+        size_t oldThreshold = BigInt::parallelThreshold;
+        BigInt::parallelThreshold = 200;
+        BigInt::setMultiplyThreads(3);
+        {
+            BlockArena arena;
+            BigInt x = a;
+            result = x * a;
+            unbalanced = x * b;
+            factorial = BigInt::factorial(3000);
+            decimal = BigDec{"0.5"} * BigDec{"3"};
+        }
+        BigInt::setMultiplyThreads(0);
+        BigInt::parallelThreshold = oldThreshold;
+        return result == expected && unbalanced == expectedUnbalanced && factorial == expectedFactorial &&
+               decimal == BigDec{"1.5"} && BlockBuffer::currentResource() == nullptr;
+    });
+
+    // Copy on write blocks
+
+    test.testBlock({
+        BlockBuffer a(100, 7);
+        const BlockBuffer& view = a;
+        BlockBuffer b = a;
+        bool shared = a.isShared() && b.isShared() && view.begin() == static_cast<const BlockBuffer&>(b).begin();
+        b[0] = 1;
+        b.push_back(2);
+        bool detached = !a.isShared() && !b.isShared() && view[0] == 7 && b[0] == 1 && b.back() == 2;
+        BlockBuffer c = a;
+        c.pop_back();
+        return shared && detached && c.isShared() && c.size() == 99 && view.size() == 100;
+    });
+
+    test.testBlock({
+        BigInt a = BigInt{3}.power(5000);
+        BigInt copy = a;
+        BigInt negated = -a;
+        copy += 1;
+        std::map<BigInt, BigInt> cache = {{1, a}};
+        return copy == a + 1 && negated + a == 0 && cache[1] == a && a == BigInt{3}.power(5000);
+    });
+
+    // Products in 10^18 limbs match the 10^9 ones
+
+#if ESTD_WIDE_LIMBS
+    test.testBlock({
+        for (auto sizes : std::vector<std::pair<size_t, size_t>>{{24, 24}, {25, 101}, {600, 531}}) {
+            for (uint32_t fill : {0u, 999999999u}) {
+                std::vector<uint32_t> a(sizes.first, fill), b(sizes.second, fill);
+                if (fill == 0) {
+                    for (size_t i = 0; i < a.size(); i++) a[i] = uint32_t(i * 123456789 % 1000000000);
+                    for (size_t i = 0; i < b.size(); i++) b[i] = uint32_t((i + 1) * 987654321 % 1000000000);
+                }
+                std::vector<uint32_t> narrow(a.size() + b.size()), wide(a.size() + b.size());
+                decimalblocks::multiplyScalar(a.data(), a.size(), b.data(), b.size(), narrow.data());
+                decimalblocks::multiplyWide(a.data(), a.size(), b.data(), b.size(), wide.data());
+                if (narrow != wide) return false;
+            }
+        }
+        BigInt nines = BigInt{10}.power(900) - 1;
+        return nines * (nines + 2) == BigInt{10}.power(1800) - 1;
+    });
+#endif
+
+    // Binary limb integers
+
+    test.testBlock({
+        BigBinInt a = "0xfedcba9876543210fedcba9876543210";
+        BigBinInt b = BigBinInt(BigInt{"-123456789012345678901234567890"});
+        return a.toString() == "338770000845734292534325025077361652240" && (a >> 100).toString(16) == "fedcba9" &&
+               (a << 68).toString(16) == "fedcba9876543210fedcba987654321000000000000000000" &&
+               b.toBigInteger() == BigInt{"-123456789012345678901234567890"} && a.bitLength() == 128 &&
+               a.popcount() == 64 && BigBinInt(-1).testBit(1000) && !BigBinInt(-4).testBit(1) &&
+               BigBinInt(-4).testBit(2) && (BigBinInt(-7) >> 1) == -4;
+    });
+
+    test.testBlock({
+        BigBinInt a = BigBinInt(1) << 200, b = BigBinInt("-0b1011");
+        return ((a - 1) & b) == (a - 1) - 15 + 5 && (a | b) == b && (a ^ b) == b - a && ~b == 10 && (-a & a) == a &&
+               BigBinInt(7).powerMod(560, 561) == 1 && BigBinInt(-7) / 2 == -3 && BigBinInt(-7) % 2 == -1 &&
+               (a * a / a) == a && BigBinInt(a.toString()) == a;
+    });
+
+    test.testBlock({
+        // large values convert (and multiply) by halves
+        BigInt x = BigInt{7}.power(20000), y = BigInt{-3}.power(30001);
+        BigBinInt a = BigBinInt(x), b = BigBinInt(y);
+        return a.getLimb(0) == 16334640562936810241ULL && a.bitLength() == 56148 && a.toBigInteger() == x &&
+               b.toBigInteger() == y && (a * b).getLimb(0) == 12647830344668876355ULL &&
+               (a * b).toBigInteger() == x * y && BigBinInt(x * 1000000000 + 1).toBigInteger() == x * 1000000000 + 1;
+    });
+
+    // Bitwise operators on decimal blocks
+
+    test.testBlock({
+        BigInt a = "-90144042682896311822508713865", b = "21173125052858393283395314067335103265";
+        BigInt both = a & b, either = a | b, other = a ^ b;
+        return both == BigInt{"21173124972618043440261876404770045985"} &&
+               either == BigInt{"-9903692839762874159943656585"} &&
+               other == BigInt{"-21173124982521736280024750564713702570"} &&
+               BigInt(~a) == BigInt{"90144042682896311822508713864"} && a.testBit(0) && a.bitLength() == 97 &&
+               BigInt(both & b) == both && BigInt(other ^ b) == a;
+    });
+
+    test.testBlock({
+        // the cached binary form follows every mutation
+        BigInt a = BigInt{2}.power(130), mask = BigInt{2}.power(64) - 1;
+        BigInt first = (a + 5) & mask;
+        a += 7;
+        BigInt second = a & mask;
+        BigInt copy = a;
+        copy *= 3;
+        a = "12";
+        return first == 5 && second == 7 && (copy & mask) == 21 && (a | 3) == 15 && BigInt(BigInt{-1} & copy) == copy;
+    });
+
+    test.testBlock({
+        BigInt a = "-1000000000000000000000000000000";
+        return (a << 70) == BigInt{"-1180591620717411303424000000000000000000000000000000"} &&
+               (a >> 70) == -847032948 && (a >> 200) == -1 && (BigInt{3} << 300) >> 299 == 6 &&
+               (BigInt{0} << 1000) == 0 && (BigInt{-5} >> 1) == -3 && (BigInt(BigInt{-5} & BigInt{-1}) >> 1) == -3 &&
+               (BigInt{-4} >> 1) == -2;
+    });
+
+    test.testBlock({
+        // mirrors built or copied inside an arena outlive it
+        BigInt x = BigInt{7}.power(100), kept, mask = BigInt{2}.power(64) - 1;
+        BigInt expected = BigInt{"3728452490685454945"};
+        bool inside;
+        {
+            BlockArena arena;
+            BigInt y = x & mask;
+            BigInt local = x * 3;
+            inside = y == expected && BigInt(local & mask) == BigInt{"11185357472056364835"};
+            kept = local;
+        }
+        return inside && BigInt(x & mask) == expected && BigInt(kept & mask) == BigInt{"11185357472056364835"} &&
+               kept == x * 3;
+    });
+
+    // Integer roots
+
+    test.testBlock({
+        BigInt big = BigInt{3}.power(4001) * 7 + 12345;
+        BigInt root = big.isqrt(), cube = big.iroot(3);
+        return root * root <= big && (root + 1) * (root + 1) > big && cube.power(3) <= big &&
+               (cube + 1).power(3) > big && BigInt{"-1000000000000000000000000000001"}.iroot(3) == -10000000000 &&
+               BigInt{"3392748151944551389109902180146366966379319296"}.iroot(4) == 241344777592 &&
+               BigInt{2}.iroot(100) == 1 && BigInt{0}.iroot(7) == 0 && BigInt{99}.isqrt() == 9;
+    });
+
+    test.testBlock({
+        BigInt square = (BigInt{10}.power(500) + 7).power(2), power = BigInt{12345}.power(97);
+        return square.isPerfectSquare() && !(square + 1).isPerfectSquare() && !BigInt{-4}.isPerfectSquare() &&
+               square.isPerfectPower() && power.isPerfectPower() && !(power - 1).isPerfectPower() &&
+               (-power).isPerfectPower() && !BigInt{-4}.isPerfectPower() && BigInt{1}.isPerfectPower() &&
+               BigInt{"39614081257132168796771975168"}.isPerfectPower() && !BigInt{1000001}.isPerfectPower();
+    });
+
+    test.testBlock({
+        // quotients long enough for the reciprocal
+        BigInt u = BigInt{7}.power(9000) + 1, v = BigInt{3}.power(5000) - 1;
+        BigInt q = u / v, r = u % v;
+        return q * v + r == u && r >= 0 && r < v && (v * v * 5 + v - 1) / v == v * 5;
+    });
+
+    // Product trees
+
+    test.testBlock({
+        BigInt naive = 1;
+        for (int i = 2; i <= 1000; i++) naive *= i;
+        return BigInt::factorial(30) == BigInt{"265252859812191058636308480000000"} &&
+               BigInt::factorial(1000) == naive && BigInt::factorial(0) == 1 &&
+               BigInt::binomial(100, 50) == BigInt{"100891344545564193334812497256"} &&
+               BigInt::binomial(1000, 997) == 166167000 && BigInt::binomial(5, 6) == 0 &&
+               BigInt::binomial(10000000000000, 2) == BigInt{"49999999999995000000000000"} &&
+               BigInt::primorial(100) == BigInt{"2305567963945518424753102147331756070"} && BigInt::primorial(1) == 1;
+    });
+
+    test.testBlock({
+        std::vector<BigInt> values = {BigInt{-3}, BigInt{"123456789012345678901234567890"}, BigInt{7}};
+        std::vector<int> small = {1, 2, 3, 4, 5, 6};
+        BigInt wide = BigInt{7}.power(20000), narrow = BigInt{3}.power(2000) + 1;
+        return BigInt::product(values) == BigInt{"-2592592569259259256925925925690"} &&
+               BigInt::product(small.begin(), small.end()) == 720 && BigInt::rangeProduct(5, 7) == 210 &&
+               BigInt::rangeProduct(3, 2) == 1 && (wide * narrow) / narrow == wide && (narrow * wide) % wide == 0;
+    });
+
+    // Product and remainder trees
+
+    test.testBlock({
+        BigInt big = BigInt{"123456789012345678901234567890"};
+        return BigInt::gcd(big * 12, big * 18) == big * 6 && BigInt::gcd(-12, 18) == 6 && BigInt::gcd(0, 0) == 0 &&
+               BigInt::gcd(big, 0) == big && BigInt{-3}.modInverse(7) == 2 && BigInt{3}.modInverse(1) == 0 &&
+               (big * big.modInverse(BigInt{10}.power(40) + 1)) % (BigInt{10}.power(40) + 1) == 1;
+    });
+
+    test.testBlock({
+        try {
+            BigInt{6}.modInverse(9);
+        } catch (std::invalid_argument&) { return true; }
+        return false;
+    });
+
+    test.testBlock({
+        std::vector<BigInt> moduli = {BigInt{7}, BigInt{"1000000000000000000000007"}, BigInt{12}, BigInt{5}};
+        BigInt x = BigInt{3}.power(300), negative = -x;
+        std::vector<BigInt> r = ProductTree::remainderTree(x, moduli), s = ProductTree(moduli).remainders(negative);
+        bool matches = ProductTree(moduli).product() == BigInt{"420000000000000000000002940"};
+        for (size_t i = 0; i < moduli.size(); i++) {
+            matches = matches && r[i] == x % moduli[i] && (s[i] + r[i]) % moduli[i] == 0 && s[i] >= 0;
+        }
+        return matches && ProductTree(std::vector<BigInt>{}).product() == 1;
+    });
+
+    test.testBlock({
+        std::vector<BigInt> moduli = {BigInt{1000000007}, BigInt{1000000009}, BigInt{"1000000000000000000000007"}, 11};
+        BigInt x = BigInt{"98765432109876543210987654321012345"};
+        std::vector<BigInt> residues;
+        for (const auto& m : moduli) residues.push_back(x % m);
+        return ProductTree::crt(residues, moduli) == x && ProductTree::crt({BigInt{-1}, BigInt{2}}, {3, 5}) == 2;
+    });
+
+    test.testBlock({
+        // parallel levels inside an arena, the remainders are built on the executor's threads
+        std::vector<BigInt> moduli;
+        for (int i = 0; i < 64; i++) moduli.push_back(BigInt{10}.power(100) + 2 * i + 1);
+        BigInt x = BigInt{7}.power(20000);
+        std::vector<BigInt> r;
+        size_t oldThreshold = BigInt::parallelThreshold;
+        BigInt::parallelThreshold = 20;
+        BigInt::setMultiplyThreads(3);
+        {
+            BlockArena arena;
+            r = ProductTree::remainderTree(x, moduli);
+        }
+        BigInt::setMultiplyThreads(0);
+        BigInt::parallelThreshold = oldThreshold;
+        bool matches = BlockBuffer::currentResource() == nullptr;
+        for (size_t i = 0; i < moduli.size(); i++) matches = matches && r[i] == x % moduli[i];
+        return matches;
+    });
+
+    // Primality
+
+    test.testBlock({
+        BigInt m127 = BigInt{2}.power(127) - 1, m521 = BigInt{2}.power(521) - 1;
+        // strong pseudoprimes to several bases and carmichael numbers
+        std::vector<BigInt> composites = {
+            BigInt{"25326001"}, BigInt{"3215031751"}, BigInt{"3825123056546413051"}, BigInt{561}, m127 * m521,
+            BigInt{"318665857834031151167461"}, BigInt{"3317044064679887385961981"}, BigInt{1194649}
+        };
+        bool none = true;
+        for (const auto& n : composites) none = none && !n.isProbablePrime();
+        return none && m127.isProbablePrime() && m521.isProbablePrime(3) && BigInt{2}.isProbablePrime() &&
+               BigInt{1999}.isProbablePrime() && BigInt{4000037}.isProbablePrime() && !BigInt{1}.isProbablePrime() &&
+               !BigInt{-7}.isProbablePrime() && !BigInt{0}.isProbablePrime();
+    });
+
+    test.testBlock({
+        BigInt googol = BigInt{10}.power(100);
+        std::mt19937_64 rng(7);
+        BigInt prime = BigInt::randomPrime(60, rng);
+        return googol.nextPrime() == googol + 267 && BigInt{-5}.nextPrime() == 2 && BigInt{2}.nextPrime() == 3 &&
+               BigInt{1999}.nextPrime() == 2003 && BigInt{4000000}.nextPrime() == 4000037 &&
+               prime.getNumDigits() == 60 && prime.isProbablePrime(2) && BigInt::randomPrime(1, rng) < 10;
+    });
+
+    test.testBlock({
+        BigInt m127 = BigInt{2}.power(127) - 1, big = BigInt{10}.power(20);
+        return BigInt{3}.modPow(-1, 7) == 5 && BigInt{2}.modPow(10, -1000) == 24 && BigInt{5}.modPow(0, 1) == 0 &&
+               BigInt{-2}.modPow(3, 7) == 6 && BigInt{7}.modPow(m127 - 1, m127) == 1 &&
+               BigInt{3}.modPow(1000, big) == BigInt{3}.power(1000) % big &&
+               BigInt{"123456789123456789"}.modPow(777, m127) == BigInt{"123456789123456789"}.power(777) % m127;
+    });
+
+    // Random numbers
+
+    test.testBlock({
+        std::mt19937_64 rng(11);
+        std::mt19937 narrow(11);
+        BigInt bound = BigInt{10}.power(27) + 1, limit = BigInt{10}.power(30);
+        bool inRange = true, hitTop = false;
+        for (int i = 0; i < 200; i++) {
+            BigInt below = BigInt::randomBelow(bound, rng), digits = BigInt::random(30, narrow);
+            BigInt bits = BigInt::randomBits(70, rng);
+            inRange = inRange && below >= 0 && below < bound && digits >= 0 && digits < limit && bits >= 0 &&
+                      bits < BigInt{2}.power(70);
+            hitTop = hitTop || digits.getNumDigits() == 30;
+        }
+        return inRange && hitTop && BigInt::randomBelow(1, rng) == 0 && BigInt::random(0, rng) == 0;
+    });
+
+    test.testBlock({
+        std::mt19937_64 rng(5);
+        int counts[3] = {0, 0, 0};
+        for (int i = 0; i < 3000; i++) counts[BigInt::randomBelow(3, rng).toInt()]++;
+        bool thrown = false;
+        try {
+            BigInt::randomBelow(0, rng);
+        } catch (std::invalid_argument&) { thrown = true; }
+        return thrown && counts[0] > 900 && counts[1] > 900 && counts[2] > 900 &&
+               (BigInt{2}.power(521) - 1).isProbablePrime(4, rng) &&
+               !BigInt{"3825123056546413051"}.isProbablePrime(2, rng);
+    });
+
+    // Rational numbers
+
+    test.testBlock({
+        BigRat x = BigRat{"6/-4"}, third = BigRat{1, 3};
+        return x.toString() == "-3/2" && x == BigRat{"-1.5"} && BigRat{2, 6} == third && third < BigRat{1, 2} &&
+               BigRat{-1, 3} > BigRat{-1, 2} && (third + third + third) == 1 && (BigRat{2, 3} / BigRat{-4, 9}) == x &&
+               BigRat{BigDec{"12.50"}}.toString() == "25/2";
+    });
+
+    test.testBlock({
+        bool same = true;
+        for (ReducePolicy policy : {ReducePolicy::EAGER, ReducePolicy::THRESHOLD, ReducePolicy::ON_DEMAND}) {
+            BigRat::policy = policy;
+            BigRat sum = 0, product = 1;
+            for (int i = 1; i <= 40; i++) {
+                sum += BigRat{1, i};
+                product *= BigRat{i + 1, i + 2};
+            }
+            same = same && sum.toString() == "2078178381193813/485721041551200" && product == BigRat{1, 21} &&
+                   (policy != ReducePolicy::EAGER || sum.isReduced()) &&
+                   std::hash<BigRat>()(product) == std::hash<BigRat>()(BigRat{2, 42});
+        }
+        BigRat::policy = ReducePolicy::THRESHOLD;
+        bool thrown = false;
+        try {
+            BigRat{1, 0};
+        } catch (std::invalid_argument&) { thrown = true; }
+        return same && thrown;
+    });
+
+    test.testBlock({
+        return BigRat{1, 3}.toBigDecimal(10).toString() == "0.3333333333" &&
+               BigRat{-2, 3}.toBigDecimal(5, RoundingMode::FLOOR).toString() == "-0.66667" &&
+               BigRat{1, 8}.toBigDecimal(2).toString() == "0.12" && BigRat{3, 8}.toBigDecimal(2).toString() == "0.38" &&
+               BigRat{1, 7}.toBigDecimal(MathContext::decimal128()).toString() ==
+                   "0.1428571428571428571428571428571429";
+    });
+
+    test.testBlock({
+        // values that truncate to zero keep their sign for the directed modes
+        BigRat small = "-1/1000";
+        return small.toBigDecimal(1, RoundingMode::FLOOR).toString() == "-0.1" &&
+               small.toBigDecimal(1, RoundingMode::UP).toString() == "-0.1" &&
+               small.toBigDecimal(1, RoundingMode::CEILING).toString() == "0" &&
+               small.toBigDecimal(1, RoundingMode::DOWN).toString() == "0" &&
+               small.toBigDecimal(1, RoundingMode::HALF_UP).toString() == "0" &&
+               BigRat{-1, 20}.toBigDecimal(1, RoundingMode::HALF_UP).toString() == "-0.1" &&
+               BigRat{1, 1000}.toBigDecimal(1, RoundingMode::CEILING).toString() == "0.1";
+    });
+
+    // Binary floating point
+
+    test.testBlock({
+        BigFloat third = BigFloat(1) / 3, root = BigFloat(2).sqrt();
+        return third.toString(30) == "0.333333333333333333333333333333" &&
+               root.toString(40) == "1.41421356237309504880168872420969807857" && (root * root - 2).sign() != 0 &&
+               BigFloat(0.1) + BigFloat(0.2) != BigFloat(0.3) && BigFloat("0.1", 53) == BigFloat(0.1) &&
+               BigFloat("6.02214076e23") == BigFloat(BigInt{"602214076000000000000000"}) &&
+               BigFloat("-2.5e-3").toDouble() == -0.0025 && third < BigFloat("0.34") && -third > BigFloat("-0.34");
+    });
+
+    test.testBlock({
+        // 2^300 + 1 needs 301 bits, ties round to the even neighbour
+        BigFloat big = BigFloat(1).scaleBinary(300);
+        BigFloat narrow(BigInt{11}, 3), mode(BigInt{11}, 3, RoundingMode::DOWN), wide = BigFloat(BigInt{13}, 4);
+        wide.setPrecision(2, RoundingMode::CEILING);
+        return (big + 1) - big == 0 && (big + BigFloat(3).scaleBinary(-100)) == big &&
+               ((big - 1) - big).isZero() && narrow == 12 && mode == 10 && wide == 16 && BigFloat(BigInt{9}, 2) == 8 &&
+               BigFloat(std::ldexp(3.0, -1076)).toDouble() == std::ldexp(1.0, -1074) &&
+               BigFloat(std::ldexp(1.0, -1075)).toDouble() == 0.0 && BigFloat("1e309").toDouble() == HUGE_VAL;
+    });
+
+    test.testBlock({
+        BigFloat x = BigFloat("0.1", 64);
+        bool thrown = false;
+        try {
+            BigFloat(-1).sqrt();
+        } catch (std::invalid_argument&) { thrown = true; }
+        return x.toBigDecimal() == BigDec{"0.1000000000000000000013552527156068805425093160010874271392822265625"} &&
+               x.toBigDecimal(MathContext{5}) == BigDec{"0.1"} && x.getPrecision() == 64 && thrown &&
+               (BigFloat(1) + x).getPrecision() == BigFloat::defaultPrecision;
+    });
+
+    test.testBlock({
+        // large decimal exponents are rounded at the working precision instead of building 10^k, ties (which
+        // no error bound can decide) fall back to the exact power
+        std::string tie = (BigInt{5}.power(200) * 3).toString() + "e-200";
+        BigFloat tiny = BigFloat("1e-100000000"), huge = BigFloat("-2.5e999999999999999999");
+        return BigFloat(tie, 1) == BigFloat(1).scaleBinary(-198) && BigFloat(tie, 2) == BigFloat(3).scaleBinary(-200) &&
+               (tiny * BigFloat("1e100000000")).toString(30) == "1" && tiny.toDouble() == 0.0 &&
+               huge.toDouble() == -HUGE_VAL && BigFloat("1e-320", 53).toDouble() == 1e-320 &&
+               BigFloat("1.7976931348623157e308", 53).toDouble() == 1.7976931348623157e308;
+    });
+
+    test.testBlock({
+        // printing rounds at the working precision too, far away values use exponent notation that reads back
+        BigFloat huge = BigFloat("1.5e200000", 64), far = BigFloat("-1e999999999999"), tiny = BigFloat("1e-100000000");
+        std::ostringstream out;
+        out << far;
+        return huge.toString(5) == "1.5e200000" && BigFloat(huge.toString(), 64) == huge &&
+               BigFloat(out.str()) == far && out.str().size() < 100 && BigFloat(tiny.toString()) == tiny &&
+               tiny.toString(3) == "1e-100000000" && tiny.toBigDecimal(MathContext{2}).toString().size() == 100000002 &&
+               BigFloat(0.015625).toString() == "0.015625" && BigFloat("2e-7", 53).toString(3) == "2e-7" &&
+               BigFloat(123456).toString(3) == "1.23e5" && BigFloat(-123456).toString(6) == "-123456" &&
+               BigFloat(BigInt{999}).toString(2) == "1e3";
+    });
+
+    // Summation accumulator
+
+    test.testBlock({
+        BigDecimalAccumulator sum;
+        BigDec expected = 0;
+        for (int i = 0; i < 1000; i++) {
+            BigDec value = BigDec{BigInt{i * 7919 % 100003} - 50000, size_t(i % 13)};
+            sum += value;
+            expected += value;
+        }
+        sum += BigDec{"123456789012345678901234567890.000000000000000001"};
+        sum -= BigDec{"123456789012345678901234567890"};
+        return sum.result() == expected + BigDec{"0.000000000000000001"} && sum.size() == 1002;
+    });
+
+    test.testBlock({
+        BigDecimalAccumulator shards[3], total;
+        for (int i = 0; i < 300; i++) {
+            BigDec value = BigDec{"0.01"} * (i - 150);
+            shards[i % 3].add(value);
+            total.subtract(value);
+        }
+        shards[0].merge(shards[1]).merge(shards[2]);
+        total.merge(shards[0]);
+        bool thrown = false;
+        try {
+            total.add(BigDec{nullptr});
+        } catch (std::invalid_argument&) { thrown = true; }
+        return shards[0].result() == BigDec{"-1.5"} && total.result() == 0 && total.size() == 600 && thrown &&
+               BigDecimalAccumulator().result() == 0;
+    });
+
+    // Lazy normalization for BigDec
+
+    test.testBlock({
+        BigDec sum = 0;
+        for (int i = 0; i < 100; i++) sum += BigDec{"0.10"};
+        return sum.toString() == "10" && sum == 10;
+    });
+
+    test.testBlock({
+        BigDec a = BigDec{"-0.50"};
+        return a.toString() == "-0.5" && (a * 2).toString() == "-1";
+    });
+
+    test.testBlock({
+        BigDec a = BigDec{"2.500"} * BigDec{"4.0"};
+        BigDec b = 10;
+        return a == b && std::hash<BigDec>{}(a) == std::hash<BigDec>{}(b);
+    });
+
+    test.testBlock({
+        size_t oldThreshold = BigDec::normalizeThreshold;
+        BigDec::normalizeThreshold = 0;
+        BigDec a = BigDec{"1.25"} + BigDec{"1.75"};
+        BigDec::normalizeThreshold = oldThreshold;
+        return a.toString() == "3";
+    });
+
+    // Division and rounding with a MathContext
+
+    test.testBlock({
+        BigDec i = BigDec{1}.divide(3, MathContext{20});
+        return i.toString() == "0.33333333333333333333";
+    });
+
+    test.testBlock({
+        BigDec i = BigDec{-2}.divide(3, MathContext{5, RoundingMode::HALF_UP});
+        BigDec k = BigDec{-2}.divide(3, MathContext{5, RoundingMode::DOWN});
+        return i.toString() == "-0.66667" && k.toString() == "-0.66666";
+    });
+
+    test.testBlock({
+        BigDec i = BigDec{"2.5"};
+        BigDec k = BigDec{"3.5"};
+        return i.round(MathContext{1}).toString() == "2" && k.round(MathContext{1}).toString() == "4";
+    });
+
+    test.testBlock({
+        BigDec i = BigDec{"123456"}.multiply(BigDec{"1.5"}, MathContext{3, RoundingMode::CEILING});
+        return i.toString() == "186000";
+    });
+
+    test.testBlock({
+        BigDec i = BigDec{"1.0000001"}.power(100000, MathContext{10});
+        return i.toString() == "1.010050167";
+    });
+
+    // Elementary functions
+
+    test.testBlock({
+        BigDec i = BigDec{2}.sqrt(MathContext{20});
+        BigDec k = BigDec{"0.0625"}.sqrt(MathContext{20});
+        return i.toString() == "1.4142135623730950488" && k.toString() == "0.25";
+    });
+
+    test.testBlock({
+        BigDec i = BigDec{1}.exp(MathContext{20});
+        BigDec k = BigDec{"-2.5"}.exp(MathContext{10});
+        return i == BigDec::e(MathContext{20}) && i.toString() == "2.7182818284590452354" &&
+               k.toString() == "0.08208499862";
+    });
+
+    test.testBlock({
+        BigDec i = BigDec{10}.ln(MathContext{20});
+        BigDec k = BigDec{"1.0000000001"}.ln(MathContext{10});
+        return i.toString() == "2.302585092994045684" && k.toString() == "0.0000000001";
+    });
+
+    test.testBlock({
+        BigDec i = BigDec{2}.power(BigDec{"0.5"}, MathContext{20});
+        BigDec k = BigDec{8}.power(BigDec{"-1.5"}, MathContext{10});
+        return i.toString() == "1.4142135623730950488" && k.toString() == "0.04419417382";
+    });
+
+    test.testBlock({
+        BigDec i = BigDec::pi(MathContext{30});
+        return i.toString() == "3.14159265358979323846264338328";
+    });
+
+    test.testBlock(
+        try { BigDec{-2}.sqrt(MathContext{10}); } catch (...) { return true; } return false;
+    );
+
+    // Exact conversions between BigDec and double / float
+
+    test.testBlock({
+        BigDec i = 0.1;
+        BigDec k = 0.1f;
+        return i.toString() == "0.1000000000000000055511151231257827021181583404541015625" &&
+               k.toString() == "0.100000001490116119384765625";
+    });
+
+    test.testBlock({
+        BigDec i = 1e300;
+        BigDec k = -5e-324;
+        return i.toDouble() == 1e300 && k.toDouble() == -5e-324 && k.toString().size() == 1077;
+    });
+
+    test.testBlock({
+        BigDec i = BigDec{"0.1"};
+        BigDec k = BigDec{"123456789012345678901234567890"};
+        return i.toDouble() == 0.1 && i.toFloat() == 0.1f && k.toDouble() == 123456789012345678901234567890.0;
+    });
+
+    test.testBlock({
+        BigDec i = BigDec{2}.power(2000);
+        return std::isinf(i.toDouble()) && std::isinf(i.toFloat()) && BigDec{"1.5"}.toFloat() == 1.5f;
+    });
+
+    test.testBlock({
+        for (double d : {1.0 / 3.0, 2.2250738585072014e-308, 4.9406564584124654e-324, 1.7976931348623157e308}) {
+            if (BigDec{d}.toDouble() != d || BigDec{-d}.toDouble() != -d) return false;
+        }
+        return true;
+    });
+
+    // FixedDecimal
+
+    test.testBlock({
+        FixedDecimal<2> a = "12.5";
+        FixedDecimal<2> b = 3;
+        return sizeof(a) == 16 && (a + b).toString() == "15.50" && (a - b * 5).toString() == "-2.50" &&
+               (a / b).toString() == "4.17";
+    });
+
+    test.testBlock({
+        FixedDecimal<2> a = "0.25";
+        FixedDecimal<2> b = "0.5";
+        FixedDecimal<2> c = "0.35";
+        return (a * b).toString() == "0.12" && (c * b).toString() == "0.18" && a < b && b > a && a != b;
+    });
+
+    test.testBlock({
+        FixedDecimal<8> a = "1000000000000000000000";
+        FixedDecimal<8> b = a;
+        for (int i = 0; i < 4; i++) b = b * a;
+        BigDec exact = BigDec{"1000000000000000000000"}.power(5);
+        bool promoted = b.isPromoted() && b.toBigDecimal() == exact;
+        b = b / a / a / a / a;
+        return promoted && !b.isPromoted() && b == a;
+    });
+
+    test.testBlock({
+        FixedDecimal<4> a = FixedDecimal<4>::rounded(BigDec{"2.71828"});
+        FixedDecimal<4> b = FixedDecimal<4>::rounded(BigDec{"-2.71828"}, RoundingMode::DOWN);
+        return a.toString() == "2.7183" && b.toString() == "-2.7182" && (a + b).toBigDecimal() == BigDec{"0.0001"};
+    });
+
+    test.testBlock(
+        try { FixedDecimal<2>{"1.005"}; } catch (...) { return true; } return false;
+    );
+
+    test.testBlock({
+        // promoted values round their quotients by magnitude, ties to even, whatever the divisor sign
+        FixedDecimal<2> big = "10000000000000000000000000000000000000000";
+        FixedDecimal<2> tie = "10000000000000000000000000000000000000000.03";
+        return (big / FixedDecimal<2>(-3)).toString() == "-3333333333333333333333333333333333333333.33" &&
+               (big / FixedDecimal<2>(3)).toString() == "3333333333333333333333333333333333333333.33" &&
+               (tie / FixedDecimal<2>(-2)).toString() == "-5000000000000000000000000000000000000000.02" &&
+               (tie / FixedDecimal<2>(2)).toString() == "5000000000000000000000000000000000000000.02";
+    });
+
+    // FixedBigInt
+
+    test.testBlock({
+        constexpr UInt256 a = (UInt256(1) << 200) + 12345;
+        static_assert((a >> 200) == 1 && a % 10 == 1, "FixedBigInt is usable in constant expressions");
+        return sizeof(a) == 32 && a.toBigInteger() == BigInt{2}.power(200) + 12345;
+    });
+
+    test.testBlock({
+        UInt256 a = "115792089237316195423570985008687907853269984665640564039457584007913129639935";
+        return a == UInt256(-1) && (a + 1) == 0 && (UInt256(0) - 1) == a && ~a == 0;
+    });
+
+    test.testBlock({
+        UInt512 a = "123456789012345678901234567890123456789012345678901234567890";
+        UInt512 b = "987654321098765432109876543210";
+        BigInt A = a.toBigInteger();
+        BigInt B = b.toBigInteger();
+        return (a * b).toBigInteger() == A * B && (a / b).toBigInteger() == A / B && (a % b).toBigInteger() == A % B;
+    });
+
+    test.testBlock({
+        UInt128 a = UInt128(-1);
+        UInt256 full = a.multiplyFull(a);
+        UInt256 m = "1000000007";
+        return full.toBigInteger() == BigInt{"340282366920938463463374607431768211455"}.power(2) &&
+               UInt256(3).powerMod(UInt256(m - 1), m) == 1 && UInt128(2).power(127).bitLength() == 128;
+    });
+
     // Power
     test.testBlock({
         BigInt base = BigInt{"2"};
@@ -490,23 +1285,21 @@ int main() {
         return result.toString() == "6172839506867283950"; // Result based on simple binary shift semantics
     });
 
-    // TODO:
-
-    // // Binary AND
-    // test.testBlock({
-    //     BigInt a = BigInt{"170"};          // Equivalent to binary 10101010
-    //     BigInt b = BigInt{"213"};          // Equivalent to binary 11010101
-    //     BigInt result = a & b;             // Binary AND operation
-    //     return result.toString() == "160"; // Equivalent to binary 10100000
-    // });
+    // Binary AND
+    test.testBlock({
+        BigInt a = BigInt{"170"};          // Equivalent to binary 10101010
+        BigInt b = BigInt{"213"};          // Equivalent to binary 11010101
+        BigInt result = a & b;             // Binary AND operation
+        return result.toString() == "128"; // Equivalent to binary 10000000
+    });
 
-    // // Binary OR
-    // test.testBlock({
-    //     BigInt a = BigInt{"170"};          // Equivalent to binary 10101010
-    //     BigInt b = BigInt{"213"};          // Equivalent to binary 11010101
-    //     BigInt result = a | b;             // Binary OR operation
-    //     return result.toString() == "223"; // Equivalent to binary 11011111
-    // });
+    // Binary OR
+    test.testBlock({
+        BigInt a = BigInt{"170"};          // Equivalent to binary 10101010
+        BigInt b = BigInt{"213"};          // Equivalent to binary 11010101
+        BigInt result = a | b;             // Binary OR operation
+        return result.toString() == "255"; // Equivalent to binary 11111111
+    });
 
     // Complex test cases that test really big numbers, verified against python to avoid long numeric constant strings
 
@@ -568,6 +1361,36 @@ int main() {
         return i.toString() == expectedOutput.at(8);
     });
 
+    //case 9 python
+    test.testBlock({
+        BigDec i = BigDec{"22"}.divide(BigDec{"7.1"}, MathContext{1000});
+        return i.toString() == expectedOutput.at(9);
+    });
+
+    //case 10 python
+    test.testBlock({
+        BigDec i = BigDec{2}.sqrt(MathContext{1000});
+        return i == BigDec{expectedOutput.at(10)}; // python keeps trailing zeros
+    });
+
+    //case 11 python
+    test.testBlock({
+        BigDec i = BigDec{"1.5"}.exp(MathContext{1000});
+        return i == BigDec{expectedOutput.at(11)};
+    });
+
+    //case 12 python
+    test.testBlock({
+        BigDec i = BigDec{2}.ln(MathContext{1000});
+        return i == BigDec{expectedOutput.at(12)};
+    });
+
+    //case 13 python
+    test.testBlock({
+        BigDec i = BigDec::pi(MathContext{1000});
+        return i == BigDec{expectedOutput.at(13)};
+    });
+
 
     std::cout << test.getStats() << std::endl;
 
@@ -1,8 +1,22 @@
 #!/bin/python3
 import sys;
+from decimal import *
 
 sys.set_int_max_str_digits(0x7FFFFFFF)
 
+def pi(c):
+    # recipe from the decimal module documentation, with a few guard digits
+    c = Context(prec=c.prec + 10)
+    three = Decimal(3)
+    lasts, t, s, n, na, d, da = 0, three, 3, 1, 0, 0, 24
+    while s != lasts:
+        lasts = s
+        n, na = n + na, na + 8
+        d, da = d + da, da + 32
+        t = c.divide(c.multiply(t, n), d)
+        s = c.add(s, t)
+    return s
+
 with open('expected.txt', 'w') as f:
     # Case 0
     i = 2
@@ -41,3 +55,24 @@ with open('expected.txt', 'w') as f:
     # Case 8
     i = 92813468712365489269086001623000003464534656458792316 % 26435
     f.write(str(i) + "\n")
+
+    # Case 9
+    c = Context(prec=1000, rounding=ROUND_HALF_EVEN)
+    i = c.divide(Decimal("22"), Decimal("7.1"))
+    f.write(str(i) + "\n")
+
+    # Case 10
+    i = c.sqrt(Decimal(2))
+    f.write(str(i) + "\n")
+
+    # Case 11
+    i = c.exp(Decimal("1.5"))
+    f.write(str(i) + "\n")
+
+    # Case 12
+    i = c.ln(Decimal("2"))
+    f.write(str(i) + "\n")
+
+    # Case 13
+    i = c.plus(pi(c))
+    f.write(str(i) + "\n")